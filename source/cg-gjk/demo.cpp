@@ -41,6 +41,7 @@ extern "C"
 #endif
 
 #include "cg_gjk.hpp"
+#include "cg_broadphase.hpp"
 
 using namespace s2cpp;
 
@@ -163,6 +164,16 @@ int main()
         }
     }
 
+    // cooked collision hulls, render meshes are non-indexed 
+    // and store each hull point multiple times.
+    gjk::convex_shape convex_shapes[PRIMITIVE_COUNT]{};
+    for(int i = 0; i < PRIMITIVE_COUNT; ++i) { 
+        const auto cook_bits = gjk::cook_convex(vertices[i].data(), (uint32_t)vertices[i].size(), &convex_shapes[i]);
+        if(mxlib::contains(cook_bits, gjk::GJK_COOK_INVALID_BIT)) {
+            printf("cooking convex shape %d failed\n", i);
+        }
+    }
+
     // materials
     const auto common_color = ColorNormalize(CLITERAL(Color){ 245, 245, 245, 128 });
     Vector4 colors[PRIMITIVE_COUNT];
@@ -186,6 +197,16 @@ int main()
 
     gjk::mesh_object       objects[PRIMITIVE_COUNT]{};
     gjk::by_products_data  results[PRIMITIVE_COUNT]{};
+
+    // simplex construction steps for the iteration visualization
+    constexpr uint32_t TRACE_CAPACITY = 128;
+    static fixed_list<mxlib::xfloat3, 4> trace_storage[PRIMITIVE_COUNT][TRACE_CAPACITY]{};
+    for(int i = 0; i < PRIMITIVE_COUNT; ++i) {
+        results[i]._simplex_construction_buffer._storage = trace_storage[i];
+    }
+    gjk::pair_cache        pair_cache{};
+    gjk::sweep_and_prune   broadphase{};
+    std::vector<gjk::object_pair> candidate_pairs{};
     
     static bool gui_ui_enabled       = true;
     static bool gizmo_move_enabled   = true;
@@ -307,10 +328,15 @@ int main()
             objects[i] = gjk::mesh_object {
                 mxlib::xfloat4x4(reinterpret_cast<float*>(&models[i].transform.m0)),
                 reinterpret_cast<mxlib::xfloat3*>(&models[i].meshes[0].vertices[0]),
-                static_cast<uint32_t>(models[i].meshes[0].vertexCount)
+                static_cast<uint32_t>(models[i].meshes[0].vertexCount),
+                nullptr,
+                &convex_shapes[i]
             };
         }
 
+        // icosphere collides as an exact sphere, vertices are kept for visualization
+        objects[2]._primitive = gjk::primitive_shape { gjk::GJK_PRIMITIVE_SPHERE, 1.5f };
+
         if(viz_mode != last_viz_mode) {
             if(viz_mode) {
                 uint32_t viz_points_size = 0;
@@ -344,40 +370,46 @@ int main()
             last_viz_mode = viz_mode;
         }
 
-        // draw primitive objects
-        for(int i = 0; i < PRIMITIVE_COUNT; ++i) 
-        {   
-            bool is_intersecting = false;
-           
-            // intersection tests
-            for(int j = 0; j < PRIMITIVE_COUNT; ++j){
-                if(i == j) continue;
-
-                const auto result_bits = gjk::intersects(&objects[i], &objects[j], 100, &results[j]);
-                const auto intersecting = mxlib::contains(result_bits, gjk::GJK_INTERSECTING_BIT);
-                const auto invalid      = mxlib::contains(result_bits, gjk::GJK_INVALID_BIT);
-
-                auto& result = results[j];
-
-                if(intersecting)
-                {
-                    is_intersecting = true;
-
-                    auto simplex = results[j]._simplex_points;
-
-                    if(viz_mode) { 
-                        if(!viz_iteration_enabled){
-                            draw_simplex(simplex, ORANGE);
-                        } else {
-                            auto max_idx  = (int)result._simplex_construction_buffer.size()-1; 
-                            if(max_idx >= 0) {
-                                int iter_ = std::clamp(viz_iteration, 0, max_idx);
-                                draw_simplex(result._simplex_construction_buffer[iter_], ORANGE);
-                            }
+        // only the pairs with overlapping bounds reach the narrowphase
+        broadphase.update(objects);
+        candidate_pairs.clear();
+        broadphase.find_pairs(candidate_pairs);
+
+        // intersection tests, once per unordered candidate pair, the answer goes to both objects
+        bool intersecting_objects[PRIMITIVE_COUNT]{};
+        for(const auto& pair : candidate_pairs) 
+        {
+            auto& warm_start = pair_cache.entry(gjk::pair_cache::make_pair_id(pair._a, pair._b));
+            const auto result_bits = gjk::intersects(&objects[pair._a], &objects[pair._b], 100, &results[pair._b], &warm_start);
+            const auto intersecting = mxlib::contains(result_bits, gjk::GJK_INTERSECTING_BIT);
+            const auto invalid      = mxlib::contains(result_bits, gjk::GJK_INVALID_BIT);
+
+            auto& result = results[pair._b];
+
+            if(intersecting)
+            {
+                intersecting_objects[pair._a] = intersecting_objects[pair._b] = true;
+
+                auto simplex = result._simplex_points;
+
+                if(viz_mode) { 
+                    if(!viz_iteration_enabled){
+                        draw_simplex(simplex, ORANGE);
+                    } else {
+                        auto max_idx  = (int)result._simplex_construction_buffer.size()-1; 
+                        if(max_idx >= 0) {
+                            int iter_ = std::clamp(viz_iteration, 0, max_idx);
+                            draw_simplex(result._simplex_construction_buffer[iter_], ORANGE);
                         }
                     }
                 }
             }
+        }
+
+        // draw primitive objects
+        for(int i = 0; i < PRIMITIVE_COUNT; ++i) 
+        {   
+            const auto is_intersecting = intersecting_objects[i];
             
             const auto overlap_color = CLITERAL(Color){ 43, 255, 156, 128 };
             const auto primitive_color = is_intersecting ? ColorNormalize(overlap_color) : colors[i];
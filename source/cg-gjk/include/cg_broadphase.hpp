@@ -0,0 +1,395 @@
+///////////////////////////////////////////////////////////////////
+// Broadphase, candidate pairs for the GJK narrowphase
+///////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "cg_gjk.hpp"
+
+#include <vector>
+#include <span>
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+
+namespace s2cpp::gjk
+{
+    inline aabb merge(const aabb& a, const aabb& b)
+    {
+        return aabb{
+            xfloat3(std::min(a._min.x, b._min.x), std::min(a._min.y, b._min.y), std::min(a._min.z, b._min.z)),
+            xfloat3(std::max(a._max.x, b._max.x), std::max(a._max.y, b._max.y), std::max(a._max.z, b._max.z)) };
+    }
+
+    // 'inner' is inside 'outer'
+    inline bool encloses(const aabb& outer, const aabb& inner)
+    {
+        return outer._min.x <= inner._min.x && outer._min.y <= inner._min.y && outer._min.z <= inner._min.z &&
+               inner._max.x <= outer._max.x && inner._max.y <= outer._max.y && inner._max.z <= outer._max.z;
+    }
+
+    // half of the surface area, cost metric of the tree builders
+    inline float half_area(const aabb& box)
+    {
+        const auto d = box._max - box._min;
+        return d.x * d.y + d.y * d.z + d.z * d.x;
+    }
+
+    // world space bounds of the object including the margin, the object bounds (see 'object_bounds') 
+    // for cooked hulls and primitives, otherwise exact from the support points along the axes.
+    // empty for objects without vertices or primitive, they never become candidates.
+    aabb world_bounds(const mesh_object& object_);
+
+    // sweep and prune (sort and sweep) over the x axis, proxies are the indices of the object
+    // array. endpoints are kept sorted between frames and re-sorted with insertion sort,
+    // coherent motion moves only a few endpoints. every overlapping unordered pair is
+    // reported once as (min index, max index), ready for 'intersects_batch'.
+    class sweep_and_prune
+    {
+    public:
+        // recomputes the bounds of 'objects_', proxies are added or dropped when the count changes
+        void update(std::span<const mesh_object> objects_);
+
+        // same with caller computed bounds, e.g. fattened or swept boxes
+        void update(std::span<const aabb> bounds_);
+
+        // appends the overlapping pairs to 'pairs_'
+        void find_pairs(std::vector<object_pair>& pairs_) const;
+
+        size_t size() const { return _bounds.size(); }
+
+        std::span<const aabb> bounds() const { return _bounds; }
+
+    private:
+        // min or max of a proxy on the sweep axis, the top bit of '_proxy' marks the max
+        struct endpoint
+        {
+            float
+            _value{};
+
+            uint32_t
+            _proxy{};
+        };
+
+        static constexpr uint32_t MAX_BIT = 0x80000000u;
+
+        void resize(const uint32_t count);
+        void sort_endpoints();
+
+        std::vector<aabb>
+        _bounds{};
+
+        std::vector<endpoint>
+        _endpoints{};
+
+        // proxies overlapping the sweep position, reused by 'find_pairs'
+        mutable std::vector<uint32_t>
+        _active{};
+    };
+
+    // fattened boxes of the dynamic tree are the bounds grown by this on every side
+    constexpr float GJK_AABB_TREE_MARGIN = 0.1f;
+
+    // dynamic bounding volume hierarchy over fattened boxes, for many moving objects in clusters.
+    // a proxy is reinserted only when its bounds leave the fat box, the tree is kept balanced 
+    // with rotations on the way up from every insertion and removal. proxy ids are stable.
+    class dynamic_aabb_tree
+    {
+    public:
+        static constexpr uint32_t NULL_NODE = ~0u;
+
+        explicit dynamic_aabb_tree(const float margin_ = GJK_AABB_TREE_MARGIN) : _margin(margin_) {}
+
+        // new proxy of 'bounds_', 'user_' is reported in the pairs (e.g. the object index)
+        uint32_t create_proxy(const aabb& bounds_, const uint32_t user_);
+        void     destroy_proxy(const uint32_t proxy_);
+
+        // returns 'true' when the proxy had to be reinserted
+        bool     move_proxy(const uint32_t proxy_, const aabb& bounds_);
+
+        // keeps one proxy per object, '_user' is the object index
+        void update(std::span<const mesh_object> objects_);
+
+        // every overlapping unordered pair of fat boxes once as (min user, max user), 
+        // from a self-overlap traversal of the tree.
+        void find_pairs(std::vector<object_pair>& pairs_) const;
+
+        // user values of the proxies overlapping 'bounds_'
+        void query(const aabb& bounds_, std::vector<uint32_t>& users_) const;
+
+        const aabb& fat_bounds(const uint32_t proxy_) const { return _nodes[proxy_]._box; }
+        uint32_t    user      (const uint32_t proxy_) const { return _nodes[proxy_]._user; }
+        int32_t     height    ()                      const { return _root == NULL_NODE ? 0 : _nodes[_root]._height; }
+        uint32_t    size      ()                      const { return _proxy_count; }
+
+    private:
+        struct node
+        {
+            aabb
+            _box{};
+
+            // next free node when on the free list
+            uint32_t
+            _parent{NULL_NODE};
+
+            uint32_t
+            _child[2]{NULL_NODE, NULL_NODE};
+
+            // leaf is 0, free node is -1
+            int32_t
+            _height{-1};
+
+            uint32_t
+            _user{};
+
+            bool is_leaf() const { return _child[0] == NULL_NODE; }
+        };
+
+        uint32_t allocate_node();
+        void     free_node(const uint32_t index);
+        void     insert_leaf(const uint32_t leaf);
+        void     remove_leaf(const uint32_t leaf);
+        void     refit(uint32_t index);
+        uint32_t balance(const uint32_t index);
+        void     self_pairs(const uint32_t index, std::vector<object_pair>& pairs_) const;
+        void     cross_pairs(const uint32_t a, const uint32_t b, std::vector<object_pair>& pairs_) const;
+
+        std::vector<node>
+        _nodes{};
+
+        uint32_t
+        _root{NULL_NODE};
+
+        uint32_t
+        _free_list{NULL_NODE};
+
+        uint32_t
+        _proxy_count{};
+
+        float
+        _margin{};
+
+        // proxy of each object of 'update'
+        std::vector<uint32_t>
+        _object_proxies{};
+    };
+
+    // persistent worker threads of the parallel builders, 'run' hands out task indices to the 
+    // workers and the calling thread and returns when all of them are done. the workers sleep 
+    // between runs, nothing is created per call. not reentrant, tasks must not call 'run'.
+    class task_pool
+    {
+    public:
+        // 'thread_count_' includes the calling thread, 0 uses the hardware concurrency
+        explicit task_pool(const uint32_t thread_count_ = 0);
+        ~task_pool();
+
+        task_pool(const task_pool&) = delete;
+        task_pool& operator=(const task_pool&) = delete;
+
+        uint32_t thread_count() const { return static_cast<uint32_t>(_workers.size()) + 1; }
+
+        // 'task_(i)' for every i in [0, task_count_)
+        void run(const uint32_t task_count_, const std::function<void(uint32_t)>& task_);
+
+    private:
+        void worker_loop();
+        void drain();
+
+        std::vector<std::thread>
+        _workers{};
+
+        std::mutex
+        _mutex{};
+
+        std::condition_variable
+        _wake{};
+
+        std::condition_variable
+        _done{};
+
+        const std::function<void(uint32_t)>*
+        _task{};
+
+        uint32_t
+        _task_count{};
+
+        std::atomic<uint32_t>
+        _next_task{};
+
+        // workers still in the current run
+        uint32_t
+        _busy_workers{};
+
+        uint64_t
+        _generation{};
+
+        bool
+        _stop{};
+    };
+
+    // cell size levels of the spatial hash grid, level k cells are 2^k times the base size
+    constexpr uint32_t GJK_HASH_GRID_LEVELS = 4;
+    // bucket count cap of the spatial hash grid (as a power of two), independent of the entry 
+    // count. keeps the per task histograms and their prefix sum small, keys are compared 
+    // when the buckets are searched so crowded buckets cost only the longer scans.
+    constexpr uint32_t GJK_HASH_GRID_MAX_BUCKET_BITS = 16;
+
+    // hierarchical spatial hash grid for many similarly sized objects spread evenly, no state 
+    // persists between frames. objects go to the finest level whose cells are at least as 
+    // large as their bounds, so they overlap at most 8 cells of it. the (cell, object) entries 
+    // are counting sorted into hashed buckets, every phase of the rebuild runs on the worker pool.
+    // pairs are reported once as (min index, max index), like 'sweep_and_prune'.
+    class spatial_hash_grid
+    {
+    public:
+        // 'cell_size_' is the base (finest) cell size, about the typical object size. 
+        // 'thread_count_' 0 uses the hardware concurrency.
+        explicit spatial_hash_grid(const float cell_size_, const uint32_t thread_count_ = 0);
+
+        // rebuilds the grid from the bounds of 'objects_'
+        void update(std::span<const mesh_object> objects_);
+
+        // same with caller computed bounds
+        void update(std::span<const aabb> bounds_);
+
+        // appends the overlapping pairs to 'pairs_'
+        void find_pairs(std::vector<object_pair>& pairs_) const;
+
+        size_t size() const { return _bounds.size(); }
+
+    private:
+        struct cell_entry
+        {
+            uint64_t
+            _key{};
+
+            uint32_t
+            _object{};
+        };
+
+        void     build();
+        uint32_t level_of(const aabb& box) const;
+        float    cell_size(const uint32_t level) const { return _cell_size * static_cast<float>(1u << level); }
+        uint32_t bucket_of(const uint64_t key) const;
+
+        float
+        _cell_size{};
+
+        std::unique_ptr<task_pool>
+        _pool{};
+
+        std::vector<aabb>
+        _bounds{};
+
+        std::vector<uint8_t>
+        _levels{};
+
+        // first entry of each object, prefix sum of the overlapped cell counts
+        std::vector<uint32_t>
+        _entry_offsets{};
+
+        std::vector<cell_entry>
+        _entries{};
+
+        // entries ordered by bucket, bucket 'b' is '_bucket_start[b]' to '_bucket_start[b + 1]'
+        std::vector<cell_entry>
+        _sorted_entries{};
+
+        std::vector<uint32_t>
+        _bucket_start{};
+
+        uint32_t
+        _bucket_shift{};
+
+        // per task bucket counts of the counting sort
+        std::vector<uint32_t>
+        _histograms{};
+
+        // chunk totals of the parallel prefix sums
+        std::vector<uint32_t>
+        _scan_sums{};
+
+        // pairs of every 'find_pairs' chunk, concatenated in order
+        mutable std::vector<std::vector<object_pair>>
+        _thread_pairs{};
+    };
+
+    // binned SAH builder settings of 'static_bvh'
+    constexpr uint32_t GJK_BVH_BIN_COUNT = 16;
+    constexpr uint32_t GJK_BVH_MAX_LEAF_SIZE = 4;
+    // deeper nodes become leaves, bounds the traversal stack
+    constexpr uint32_t GJK_BVH_MAX_DEPTH = 48;
+
+    // flat node of 'static_bvh', depth-first order. the left child of an internal node is 
+    // the next node, '_offset' is the right child. leaves have '_count' > 0 primitives 
+    // starting at '_offset' in the primitive index array.
+    struct bvh_node
+    {
+        float
+        _min[3]{};
+
+        uint32_t
+        _offset{};
+
+        float
+        _max[3]{};
+
+        uint32_t
+        _count{};
+    };
+
+    static_assert(sizeof(bvh_node) == 32, "two nodes per 64 byte cache line");
+
+    // bounding volume hierarchy over static geometry, built once (e.g. at level load) with 
+    // binned SAH on a worker pool, the top levels are binned in parallel and their subtrees 
+    // are built as parallel tasks. moving objects are queried against it, the static objects 
+    // need no pairwise tests among themselves.
+    class static_bvh
+    {
+    public:
+        // 'thread_count_' 0 uses the hardware concurrency
+        explicit static_bvh(const uint32_t thread_count_ = 0);
+
+        void build(std::span<const mesh_object> objects_);
+        void build(std::span<const aabb> bounds_);
+
+        // indices of the static primitives overlapping 'bounds_'
+        void query(const aabb& bounds_, std::vector<uint32_t>& primitives_) const;
+
+        // candidates of the moving objects against the static ones, '_a' indexes 'moving_' 
+        // and '_b' the static primitives of the build.
+        void find_pairs(std::span<const mesh_object> moving_, std::vector<object_pair>& pairs_) const;
+        void find_pairs(std::span<const aabb> moving_, std::vector<object_pair>& pairs_) const;
+
+        std::span<const bvh_node> nodes() const { return _nodes; }
+        std::span<const uint32_t> primitive_indices() const { return _primitive_indices; }
+
+    private:
+        struct build_node;
+
+        uint32_t split_range(build_node& node, const uint32_t begin, const uint32_t end, const uint32_t depth, task_pool* pool);
+        std::unique_ptr<build_node> build_range(const uint32_t begin, const uint32_t end, const uint32_t depth);
+        void flatten(const build_node& node);
+
+        std::unique_ptr<task_pool>
+        _pool{};
+
+        std::vector<bvh_node>
+        _nodes{};
+
+        std::vector<uint32_t>
+        _primitive_indices{};
+
+        // build inputs, released after the build
+        std::vector<aabb>
+        _bounds{};
+
+        std::vector<xfloat3>
+        _centroids{};
+    };
+};
@@ -7,11 +7,247 @@
 #include "mxlib.hpp"
 
 #include <vector>
+#include <unordered_map>
+#include <span>
 
 using namespace mxlib;
 
 namespace s2cpp::gjk
 {
+    // vertex streams of 'soa_vertices' are padded to multiple of this,
+    // widest supported vector width (AVX2, 8 x 32 bit lanes).
+    constexpr uint32_t GJK_SOA_PADDING = 8;
+
+    // structure-of-arrays copy of the vertices for the vectorized support kernel,
+    // padding is filled by repeating the first vertex so it can never win the search.
+    struct soa_vertices
+    {
+        std::vector<float>
+        _x{};
+
+        std::vector<float>
+        _y{};
+
+        std::vector<float>
+        _z{};
+
+        // vertex count without padding
+        uint32_t
+        _vertex_count{};
+    };
+
+    // relative tolerance of the termination tests, the origin is considered to be on the simplex 
+    // when its distance is within this fraction of the size (furthest vertex) of the simplex.
+    constexpr float GJK_RELATIVE_EPSILON = 1e-5f;
+
+    // hulls with fewer vertices than this are searched with the linear scan,
+    // hill-climbing pays off only when the scan gets long.
+    constexpr uint32_t GJK_HILL_CLIMB_MIN_VERTICES = 64;
+
+    // cube map direction lookup table resolution, cells per face side 
+    constexpr uint32_t GJK_DIRECTION_LUT_RESOLUTION = 16;
+    constexpr uint32_t GJK_DIRECTION_LUT_CELL_COUNT = 6 * GJK_DIRECTION_LUT_RESOLUTION * GJK_DIRECTION_LUT_RESOLUTION;
+
+    // quantizes a direction to cube map cell, face is picked by the major axis
+    // and the two remaining components are projected on the face.
+    inline uint32_t direction_lut_cell(const xfloat3& direction)
+    {
+        constexpr auto resolution = GJK_DIRECTION_LUT_RESOLUTION;
+
+        const auto ax = direction.x < 0 ? -direction.x : direction.x;
+        const auto ay = direction.y < 0 ? -direction.y : direction.y;
+        const auto az = direction.z < 0 ? -direction.z : direction.z;
+
+        uint32_t face = 0;
+        float u = 0, v = 0, major = 0;
+        if(ax >= ay && ax >= az) { 
+            face = direction.x >= 0 ? 0 : 1; u = direction.y; v = direction.z; major = ax; 
+        } else if(ay >= az) { 
+            face = direction.y >= 0 ? 2 : 3; u = direction.x; v = direction.z; major = ay; 
+        } else { 
+            face = direction.z >= 0 ? 4 : 5; u = direction.x; v = direction.y; major = az; 
+        }
+
+        if(major <= 0) {
+            return 0;
+        }
+
+        const auto to_cell = [](float c) {
+            const auto cell = static_cast<int32_t>((c + 1.0f) * 0.5f * resolution);
+            return static_cast<uint32_t>(cell < 0 ? 0 : (cell >= (int32_t)resolution ? resolution - 1 : cell));
+        };
+
+        return (face * resolution + to_cell(v / major)) * resolution + to_cell(u / major);
+    }
+
+    struct convex_shape_builder;
+
+    // axis aligned bounding box, empty when '_min' > '_max'
+    struct aabb
+    {
+        xfloat3
+        _min{};
+
+        xfloat3
+        _max{};
+    };
+
+    // closed intervals, touching boxes overlap
+    inline bool overlaps(const aabb& a, const aabb& b)
+    {
+        return a._min.x <= b._max.x && b._min.x <= a._max.x &&
+               a._min.y <= b._max.y && b._min.y <= a._max.y &&
+               a._min.z <= b._max.z && b._min.z <= a._max.z;
+    }
+
+    // compact, immutable convex hull of a point cloud, only hull vertices are stored
+    // (welded, interior points removed). can be only created with 'cook_convex' 
+    // and shared between any number of mesh objects.
+    class convex_shape
+    {
+    public:
+        const xfloat3*  vertices()       const { return _vertices.data(); }
+        uint32_t        vertex_count()   const { return static_cast<uint32_t>(_vertices.size()); }
+
+        // hull triangles, three indices per triangle, counter-clockwise seen from outside
+        const uint32_t* indices()        const { return _indices.data(); }
+        uint32_t        triangle_count() const { return static_cast<uint32_t>(_indices.size() / 3); }
+        
+        const soa_vertices& soa()        const { return _soa; }
+
+        // average of the hull vertices, guaranteed to be inside the hull
+        const xfloat3&  center()         const { return _center; }
+
+        // local space bounds of the hull, the sphere is centered at the middle of the box
+        const aabb&     local_bounds()   const { return _local_bounds; }
+        const xfloat3&  sphere_center()  const { return _sphere_center; }
+        float           sphere_radius()  const { return _sphere_radius; }
+
+        // vertex adjacency graph of the hull in compressed rows, neighbours of the
+        // vertex 'i' are 'adjacency()[adjacency_offsets()[i] .. adjacency_offsets()[i + 1]]'.
+        // empty if not requested in 'cook_options'.
+        bool            has_adjacency()     const { return !_adjacency_offsets.empty(); }
+        const uint32_t* adjacency_offsets() const { return _adjacency_offsets.data(); }
+        const uint32_t* adjacency()         const { return _adjacency.data(); }
+
+        // best support vertex for the center direction of each 'direction_lut_cell',
+        // empty if not requested in 'cook_options'.
+        bool            has_direction_lut() const { return !_direction_lut.empty(); }
+        const uint32_t* direction_lut()     const { return _direction_lut.data(); }
+
+    private:
+        friend struct convex_shape_builder;
+
+        std::vector<xfloat3>
+        _vertices{};
+
+        std::vector<uint32_t>
+        _indices{};
+
+        soa_vertices
+        _soa{};
+
+        xfloat3
+        _center{};
+
+        aabb
+        _local_bounds{};
+
+        xfloat3
+        _sphere_center{};
+
+        float
+        _sphere_radius{};
+
+        std::vector<uint32_t>
+        _adjacency_offsets{};
+
+        std::vector<uint32_t>
+        _adjacency{};
+
+        std::vector<uint32_t>
+        _direction_lut{};
+    };
+
+    struct cook_options
+    {
+        // vertices closer than this are merged into one
+        float
+        _weld_tolerance{1e-4f};
+
+        // vertex adjacency for the hill-climbing support search
+        bool
+        _build_adjacency{true};
+
+        // cube map of support vertices used as the starting point of the hill-climbing, 
+        // meant for very large hulls, takes 'GJK_DIRECTION_LUT_CELL_COUNT' * 4 bytes.
+        // implies '_build_adjacency'.
+        bool
+        _build_direction_lut{false};
+    };
+
+    typedef enum cook_result_bits : uint8_t {
+        GJK_COOK_EMPTY_MASK                    = 0,    // 0000 0000
+        GJK_COOK_INVALID_BIT                   = 0x1,  // 0000 0001
+        GJK_COOK_ERROR_NULL_VERTEX_ARRAY_BIT   = 0x2,  // 0000 0010
+        GJK_COOK_ERROR_NULL_SHAPE_BIT          = 0x4,  // 0000 0100
+        GJK_COOK_ERROR_NOT_ENOUGH_VERTICES_BIT = 0x8,  // 0000 1000
+        // all the vertices are on the same plane (or line), there is no volume
+        GJK_COOK_ERROR_DEGENERATE_BIT          = 0x10, // 0001 0000
+
+    } cook_result_bits;
+
+    typedef enum primitive_type : uint8_t {
+        // not a primitive, vertices describe the object
+        GJK_PRIMITIVE_NONE      = 0,
+        GJK_PRIMITIVE_SPHERE    = 1,
+        GJK_PRIMITIVE_CAPSULE   = 2,
+        GJK_PRIMITIVE_BOX       = 3,
+        GJK_PRIMITIVE_CYLINDER  = 4,
+        GJK_PRIMITIVE_CONE      = 5,
+        GJK_PRIMITIVE_ELLIPSOID = 6,
+
+    } primitive_type;
+
+    // implicit shape with a closed-form support function, no vertices needed. all primitives 
+    // are centered at the local origin, capsule, cylinder and cone are aligned with the local y axis.
+    struct primitive_shape
+    {
+        primitive_type
+        _type{GJK_PRIMITIVE_NONE};
+
+        // sphere, capsule and cylinder radius, cone base radius
+        float
+        _radius{};
+
+        // capsule (segment), cylinder and cone half height, cone apex is at +y
+        float
+        _half_height{};
+
+        // box half extents, ellipsoid radii
+        xfloat3
+        _half_extents{};
+    };
+
+    // world space bounds of a 'mesh_object' for the model matrix they were computed with
+    struct bounds_cache
+    {
+        xfloat4x4
+        _model_mtx{};
+
+        aabb
+        _box{};
+
+        xfloat3
+        _sphere_center{};
+
+        float
+        _sphere_radius{};
+
+        bool
+        _valid{};
+    };
+
     struct mesh_object
     {
         xfloat4x4
@@ -22,18 +258,303 @@ namespace s2cpp::gjk
 
         uint32_t
         _vertex_count{};
+
+        // optional, when set support points are searched with the vectorized kernel,
+        // must be built from '_vertices' with 'build_soa_vertices'.
+        const soa_vertices*
+        _soa_vertices{};
+
+        // optional, when set the cooked hull is used instead of '_vertices', 
+        // '_vertex_count' and '_soa_vertices'.
+        const convex_shape*
+        _convex_shape{};
+
+        // optional, when '_type' is set the analytic support function is used, 
+        // vertices are ignored. takes precedence over '_convex_shape'.
+        primitive_shape
+        _primitive{};
+
+        // optional collision margin, the object is its core shape (vertices, hull or primitive) 
+        // inflated by this radius. queries run on the core and add the margin analytically.
+        float
+        _margin{};
+
+        // filled by 'update_bounds', the queries only read it and compute the bounds for the call 
+        // while it is stale ('_model_mtx' changed). reset it ('= {}') when the shape, primitive 
+        // or margin of the object changes.
+        bounds_cache
+        _bounds_cache{};
     };
 
     // for visualization
+    // fixed capacity ring of simplex snapshots over caller provided storage, nothing is allocated 
+    // while tracing. when full the oldest snapshots are overwritten, the latest ones are kept.
+    struct simplex_trace
+    {
+        std::span<fixed_list<xfloat3, 4>>
+        _storage{};
+
+        // snapshots written since the last reset, including the overwritten ones
+        uint32_t
+        _written{};
+
+        void reset() { _written = 0; }
+
+        void push(const fixed_list<xfloat3, 4>& simplex_)
+        {
+            if(_storage.empty()) {
+                return;
+            }
+            _storage[_written % _storage.size()] = simplex_;
+            ++_written;
+        }
+
+        uint32_t capacity() const { return static_cast<uint32_t>(_storage.size()); }
+        uint32_t size()     const { return _written < capacity() ? _written : capacity(); }
+
+        // retained snapshots, oldest first
+        const fixed_list<xfloat3, 4>& operator[](const uint32_t index_) const
+        {
+            const auto first = _written - size();
+            return _storage[(first + index_) % _storage.size()];
+        }
+    };
+
     struct by_products_data
     {   
         fixed_list<xfloat3, 4> 
         _simplex_points{};
 
-        std::vector<fixed_list<mxlib::xfloat3, 4>>
+        // simplex after each iteration, empty storage disables the capture
+        simplex_trace
         _simplex_construction_buffer{};
+
+        // keeps the trace storage
+        void reset() 
+        { 
+            _simplex_points.reset(); 
+            _simplex_construction_buffer.reset(); 
+        }
     };
 
+    // state of the last terminating simplex of an object pair, seeds the next query of 
+    // the same pair. with small motion between queries the pair converges in 1-2 iterations.
+    struct simplex_cache_entry
+    {
+        // support vertex indices of the simplex points, '_vertices' or the cooked hull
+        uint32_t
+        _indices_a[4]{};
+
+        uint32_t
+        _indices_b[4]{};
+
+        // 0 when empty, 4 when the pair was intersecting
+        uint8_t
+        _count{};
+
+        // last separating direction
+        xfloat3
+        _direction{};
+    };
+
+    // persistent warm start state for object pairs, keyed by a caller provided pair id.
+    // queries are ordered, (a, b) and (b, a) must use different ids.
+    class pair_cache
+    {
+    public:
+        static constexpr uint64_t make_pair_id(uint32_t id_a, uint32_t id_b) {
+            return (static_cast<uint64_t>(id_a) << 32) | id_b;
+        }
+
+        simplex_cache_entry& entry (const uint64_t pair_id) { return _entries[pair_id]; }
+        void                 remove(const uint64_t pair_id) { _entries.erase(pair_id); }
+        void                 clear ()                       { _entries.clear(); }
+        size_t               size  ()                 const { return _entries.size(); }
+
+    private:
+        std::unordered_map<uint64_t, simplex_cache_entry>
+        _entries{};
+    };
+
+    struct distance_result
+    {
+        // separation distance, zero when the objects are intersecting
+        float
+        _distance{};
+
+        // closest points on the objects in world space
+        xfloat3
+        _point_a{};
+
+        xfloat3
+        _point_b{};
+
+        // unit vector from '_point_a' towards '_point_b'
+        xfloat3
+        _separating_axis{};
+    };
+
+    struct contact_result
+    {
+        // penetration depth, translating beta by '_normal' * '_depth' separates the objects
+        float
+        _depth{};
+
+        // unit contact normal from alpha towards beta
+        xfloat3
+        _normal{};
+
+        // deepest points of the objects in world space
+        xfloat3
+        _point_a{};
+
+        xfloat3
+        _point_b{};
+    };
+
+    // expanding polytope algorithm (EPA) working memory, vectors keep their capacity 
+    // between queries so reusing the same scratch doesn't allocate in the steady state.
+    struct epa_vertex
+    {
+        xfloat3
+        _position{};
+
+        xfloat3
+        _support_a{};
+
+        xfloat3
+        _support_b{};
+
+        uint32_t
+        _index_a{};
+
+        uint32_t
+        _index_b{};
+    };
+
+    struct epa_face
+    {
+        uint32_t
+        _v[3]{};
+
+        // outward unit normal and the distance of the face plane from the origin
+        xfloat3
+        _normal{};
+
+        float
+        _distance{};
+    };
+
+    struct epa_edge
+    {
+        uint32_t
+        _a{};
+
+        uint32_t
+        _b{};
+    };
+
+    struct epa_scratch
+    {
+        std::vector<epa_vertex>
+        _vertices{};
+
+        std::vector<epa_face>
+        _faces{};
+
+        std::vector<epa_edge>
+        _edges{};
+    };
+
+    // indices of the tested objects in the batch object array
+    struct object_pair
+    {
+        uint32_t
+        _a{};
+
+        uint32_t
+        _b{};
+    };
+
+    // batch working memory, keeps its capacity between batches
+    struct batch_scratch
+    {
+        // pair processing order
+        std::vector<uint32_t>
+        _order{};
+
+        // validation bits per object
+        std::vector<uint8_t>
+        _object_bits{};
+    };
+
+    struct batch_options
+    {
+        uint32_t
+        _max_iter{100};
+
+        // process pairs grouped by their shapes (vertex data) so the 
+        // same vertices stay hot in cache between the pairs.
+        bool
+        _group_by_shape{true};
+    };
+
+    typedef enum narrowphase_algorithm : uint8_t {
+        // exact penetration with GJK and EPA
+        GJK_ALGORITHM_GJK_EPA = 0,
+        // approximate penetration with minkowski portal refinement, cheaper 
+        GJK_ALGORITHM_MPR     = 1,
+
+    } narrowphase_algorithm;
+
+    typedef enum termination_strategy : uint8_t {
+        // relative tolerance and repeated support point detection, 'GJK_NOT_CONVERGED_BIT' 
+        // when the loop stalls or reaches 'max_iter_'
+        GJK_TERMINATION_RELATIVE      = 0,
+        // iteration cap only, no duplicate scan per iteration, for well separated 
+        // or clearly overlapping pairs where stalls are rare
+        GJK_TERMINATION_ITERATION_CAP = 1,
+
+    } termination_strategy;
+
+    // compile-time configuration of the GJK kernel, every entry point taking a policy is 
+    // instantiated for it and pays only for what is enabled.
+    //
+    // 'WITNESS'     - simplex vertices keep the support points of both objects and their vertex 
+    //                 indices (needed by warm start), otherwise only the minkowski position and 
+    //                 the support search keeps just the vertex indices it starts from.
+    // 'TRACE'       - simplex construction is captured into 'by_products_data'.
+    // 'SCALAR'      - scalar type of the shape type kernel ('cg_gjk_shapes.hpp'), 'float' or 
+    //                 'double'. mesh objects store single precision matrices and vertices, 
+    //                 their queries accept 'float' only and use 'REBASE' far from the origin.
+    // 'TERMINATION' - see 'termination_strategy'.
+    // 'REBASE'      - mesh objects are translated by minus the midpoint of the pair (computed in 
+    //                 double) before the single precision kernel runs, keeps the precision of 
+    //                 pairs far from the world origin. results are translation invariant.
+    template<bool WITNESS, bool TRACE, typename SCALAR = float, termination_strategy TERMINATION = GJK_TERMINATION_RELATIVE, bool REBASE = false>
+    struct gjk_policy
+    {
+        static constexpr bool track_witness = WITNESS;
+        static constexpr bool trace         = TRACE;
+
+        using scalar = SCALAR;
+
+        static constexpr termination_strategy termination = TERMINATION;
+
+        static constexpr bool rebase_origin = REBASE;
+    };
+
+    // what the plain 'intersects' runs without 'by_products'
+    using default_policy = gjk_policy<true,  false>;
+    // what the plain 'intersects' runs with 'by_products'
+    using trace_policy   = gjk_policy<true,  true>;
+    // yes/no answer only, smallest simplex vertices, no warm start
+    using boolean_policy = gjk_policy<false, false>;
+    // yes/no answer with the iteration cap only
+    using boolean_capped_policy = gjk_policy<false, false, float, GJK_TERMINATION_ITERATION_CAP>;
+    // 'default_policy' for pairs far from the world origin
+    using rebased_policy = gjk_policy<true,  false, float, GJK_TERMINATION_RELATIVE, true>;
+
     typedef enum result_bits : uint8_t {
         GJK_EMPTY_MASK                    = 0,    // 0000 0000
         
@@ -47,14 +568,101 @@ namespace s2cpp::gjk
         
         // result bits
         GJK_INTERSECTING_BIT              = 0x40, // 0100 0000
-        // lets leave the last bit for a later use
-        GJK_EXTRA_BIT                     = 0x80, // 1000 0000
+        // iteration stopped without converging ('max_iter_' was reached or the support search 
+        // stalled on float noise), the rest of the result is the best guess at that point.
+        GJK_NOT_CONVERGED_BIT             = 0x80, // 1000 0000
 
     } result_bits;
 
+    void build_soa_vertices (
+        const xfloat3* vertices_,
+        const uint32_t vertex_count_,
+        soa_vertices*  soa_);
+
+    // one-time step, welds duplicate vertices, computes the convex hull 
+    // and throws away the interior points.
+    gjk::cook_result_bits cook_convex (
+        const xfloat3*      vertices_,
+        const uint32_t      vertex_count_,
+        convex_shape*       shape_,
+        const cook_options& options_ = {});
+
+    gjk::result_bits intersects (
+        const mesh_object* alpha_, 
+        const mesh_object* beta_, 
+        const uint32_t       max_iter_ = 100, 
+        by_products_data*    by_products = nullptr,
+        simplex_cache_entry* warm_start = nullptr);
+
+    // fills the cached world bounds of the object when they are stale. the bounds are transformed 
+    // from the local bounds of the cooked hull or primitive (conservative under rotation) and 
+    // inflated by the margin, raw vertices have none without a scan. call it after moving the 
+    // object, not while other threads query it.
+    void update_bounds(mesh_object& object_);
+
+    // the cached bounds of the object when they are current, otherwise computed into 'scratch_' 
+    // without writing the object. nullptr for raw vertices.
+    const bounds_cache* object_bounds(const mesh_object& object_, bounds_cache& scratch_);
+
+    // 'intersects' with the kernel configured by 'Policy', instantiated for the policies 
+    // above. 'by_products' is required by tracing policies, 'warm_start' is used only when 
+    // witnesses are tracked.
+    template<typename Policy>
     gjk::result_bits intersects (
         const mesh_object* alpha_, 
         const mesh_object* beta_, 
-        const uint32_t     max_iter_ = 100, 
-        by_products_data*  by_products = nullptr);
+        const uint32_t       max_iter_ = 100, 
+        by_products_data*    by_products = nullptr,
+        simplex_cache_entry* warm_start = nullptr);
+
+    // separation distance and the closest points of the objects, returns 'GJK_INTERSECTING_BIT'
+    // (and zero distance) when the objects are intersecting. 'tolerance_' is relative to
+    // the squared distance, iteration stops when the next support point can't improve more.
+    gjk::result_bits distance (
+        const mesh_object* alpha_, 
+        const mesh_object* beta_, 
+        distance_result*   result_,
+        const uint32_t     max_iter_  = 100,
+        const float        tolerance_ = 1e-6f);
+
+    // penetration depth, contact normal and witness points for intersecting objects, GJK terminating 
+    // simplex is expanded with EPA. returns 'GJK_INTERSECTING_BIT' when 'result_' was filled.
+    // 'scratch_' is optional, without it the working memory is allocated for the call.
+    gjk::result_bits penetration (
+        const mesh_object* alpha_, 
+        const mesh_object* beta_, 
+        contact_result*    result_,
+        epa_scratch*       scratch_   = nullptr,
+        const uint32_t     max_iter_  = 100,
+        const float        tolerance_ = 1e-4f);
+
+    // minkowski portal refinement (MPR, XenoCollide), boolean test with an approximate
+    // contact normal and depth without EPA. returns 'GJK_INTERSECTING_BIT' when 'result_' was filled, 
+    // 'GJK_NOT_CONVERGED_BIT' alone when no portal was found within 'max_iter_'. a portal collapsing 
+    // to a segment falls back to 'penetration'.
+    gjk::result_bits mpr_penetration (
+        const mesh_object* alpha_, 
+        const mesh_object* beta_, 
+        contact_result*    result_,
+        const uint32_t     max_iter_  = 100,
+        const float        tolerance_ = 1e-4f);
+
+    // shared entry point for the penetration queries, algorithm is selected per query.
+    gjk::result_bits collide (
+        const mesh_object*          alpha_, 
+        const mesh_object*          beta_, 
+        const narrowphase_algorithm algorithm_,
+        contact_result*             result_,
+        epa_scratch*                scratch_  = nullptr,
+        const uint32_t              max_iter_ = 100);
+
+    // batched 'intersects', objects are validated once per batch and pairs can be reordered 
+    // by shape, 'results_[i]' is the result of 'pairs_[i]'. 'scratch_' is optional, 
+    // without it the working memory is allocated for the call.
+    void intersects_batch (
+        std::span<const mesh_object> objects_,
+        std::span<const object_pair> pairs_,
+        std::span<result_bits>       results_,
+        batch_scratch*               scratch_ = nullptr,
+        const batch_options&         options_ = {});
 };
\ No newline at end of file
@@ -0,0 +1,853 @@
+///////////////////////////////////////////////////////////////////
+// Gilbert–Johnson–Keerthi (GJK) over compile-time shape types
+///////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "cg_gjk.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <array>
+#include <concepts>
+#include <utility>
+
+namespace s2cpp::gjk
+{
+    // double precision counterparts of 'xfloat3' and 'xfloat4x4' for the shape types, same 
+    // free function interface (found by argument dependent lookup) so the templates below 
+    // are written once for both scalars.
+    struct xdouble3
+    {
+        double x{};
+        double y{};
+        double z{};
+
+        constexpr xdouble3() = default;
+        constexpr xdouble3(const double x_, const double y_, const double z_) : x(x_), y(y_), z(z_) {}
+    };
+
+    inline xdouble3 operator+(const xdouble3& a, const xdouble3& b) { return xdouble3(a.x + b.x, a.y + b.y, a.z + b.z); }
+    inline xdouble3 operator-(const xdouble3& a, const xdouble3& b) { return xdouble3(a.x - b.x, a.y - b.y, a.z - b.z); }
+    inline xdouble3 operator*(const xdouble3& a, const double s) { return xdouble3(a.x * s, a.y * s, a.z * s); }
+
+    inline double   dot_product(const xdouble3& a, const xdouble3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+    inline xdouble3 cross_product(const xdouble3& a, const xdouble3& b) { return xdouble3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x); }
+    inline double   mixed_product(const xdouble3& a, const xdouble3& b, const xdouble3& c) { return dot_product(cross_product(a, b), c); }
+    inline xdouble3 negate(const xdouble3& a) { return xdouble3(-a.x, -a.y, -a.z); }
+
+    // row major, translation in [3], [7], [11] like 'xfloat4x4'
+    struct xdouble4x4
+    {
+        double
+        _m[16]{};
+
+        double& operator[](const size_t i) { return _m[i]; }
+        const double& operator[](const size_t i) const { return _m[i]; }
+    };
+
+    inline xdouble3 transform(const xdouble3& v, const xdouble4x4& m)
+    {
+        return xdouble3(
+            m[0] * v.x + m[1] * v.y + m[2]  * v.z + m[3],
+            m[4] * v.x + m[5] * v.y + m[6]  * v.z + m[7],
+            m[8] * v.x + m[9] * v.y + m[10] * v.z + m[11]);
+    }
+
+    // vector types and tolerances of a scalar type
+    template<typename T>
+    struct scalar_traits;
+
+    template<>
+    struct scalar_traits<float>
+    {
+        using vec3 = xfloat3;
+        using mat4 = xfloat4x4;
+
+        static constexpr float relative_epsilon = GJK_RELATIVE_EPSILON;
+    };
+
+    template<>
+    struct scalar_traits<double>
+    {
+        using vec3 = xdouble3;
+        using mat4 = xdouble4x4;
+
+        static constexpr double relative_epsilon = 1e-12;
+    };
+
+    template<typename T>
+    using vec3_t = typename scalar_traits<T>::vec3;
+
+    template<typename T>
+    using mat4_t = typename scalar_traits<T>::mat4;
+
+    template<typename Vec>
+    using vec_scalar_t = std::remove_cvref_t<decltype(std::declval<Vec>().x)>;
+
+    // shape types declare their scalar as 'scalar', shapes without one (mesh objects) are single precision
+    template<typename Shape>
+    struct shape_scalar { using type = float; };
+
+    template<typename Shape> requires requires { typename Shape::scalar; }
+    struct shape_scalar<Shape> { using type = typename Shape::scalar; };
+
+    template<typename Shape>
+    using shape_scalar_t = typename shape_scalar<Shape>::type;
+
+    template<typename To, typename From>
+    inline To convert_vec3(const From& v)
+    {
+        if constexpr (std::is_same_v<To, From>) {
+            return v;
+        } else {
+            using scalar = vec_scalar_t<To>;
+            return To(static_cast<scalar>(v.x), static_cast<scalar>(v.y), static_cast<scalar>(v.z));
+        }
+    }
+
+    // shape types are plain structs with a world space support function 'support(shape, direction)' 
+    // found by argument dependent lookup, the support calls of a pair are resolved at compile time 
+    // and can be inlined into the GJK loop. optional 'center(shape)' is used for the initial search direction.
+    // directions and points are in the scalar type of the shape, see 'shape_scalar'.
+    template<typename T>
+    concept support_shape = requires(const T& shape_, const vec3_t<shape_scalar_t<T>>& direction) {
+        { support(shape_, direction) } -> std::convertible_to<vec3_t<shape_scalar_t<T>>>;
+    };
+
+    template<typename T = float>
+    struct basic_sphere_shape
+    {
+        using scalar = T;
+
+        vec3_t<T>
+        _center{};
+
+        T
+        _radius{};
+    };
+
+    // segment 'a' => 'b' inflated by the radius
+    template<typename T = float>
+    struct basic_capsule_shape
+    {
+        using scalar = T;
+
+        vec3_t<T>
+        _a{};
+
+        vec3_t<T>
+        _b{};
+
+        T
+        _radius{};
+    };
+
+    // oriented box centered at the local origin
+    template<typename T = float>
+    struct basic_box_shape
+    {
+        using scalar = T;
+
+        mat4_t<T>
+        _model_mtx{};
+
+        vec3_t<T>
+        _half_extents{};
+    };
+
+    using sphere_shape  = basic_sphere_shape<float>;
+    using capsule_shape = basic_capsule_shape<float>;
+    using box_shape     = basic_box_shape<float>;
+
+    // double precision shapes, for scenes far from the origin
+    using sphere_shape_d  = basic_sphere_shape<double>;
+    using capsule_shape_d = basic_capsule_shape<double>;
+    using box_shape_d     = basic_box_shape<double>;
+
+    template<typename T>
+    inline vec3_t<T> support(const basic_sphere_shape<T>& shape_, const vec3_t<T>& direction)
+    {
+        const auto length = std::sqrt(dot_product(direction, direction));
+        if(length == 0) {
+            return shape_._center;
+        }
+        return shape_._center + direction * (shape_._radius / length);
+    }
+
+    template<typename T>
+    inline vec3_t<T> center(const basic_sphere_shape<T>& shape_) { return shape_._center; }
+
+    template<typename T>
+    inline vec3_t<T> support(const basic_capsule_shape<T>& shape_, const vec3_t<T>& direction)
+    {
+        const auto length = std::sqrt(dot_product(direction, direction));
+        const auto& end = dot_product(shape_._b - shape_._a, direction) > 0 ? shape_._b : shape_._a;
+        if(length == 0) {
+            return end;
+        }
+        return end + direction * (shape_._radius / length);
+    }
+
+    template<typename T>
+    inline vec3_t<T> center(const basic_capsule_shape<T>& shape_) { return (shape_._a + shape_._b) * T(0.5); }
+
+    namespace detail
+    {
+        // world space direction to the local space, transpose of the upper 3x3, 
+        // support of a linearly transformed shape is max((Mᵀd) · v).
+        template<typename Vec, typename Mat>
+        inline Vec direction_to_local(const Vec& direction, const Mat& m)
+        {
+            return Vec(
+                m[0] * direction.x + m[4] * direction.y + m[8]  * direction.z,
+                m[1] * direction.x + m[5] * direction.y + m[9]  * direction.z,
+                m[2] * direction.x + m[6] * direction.y + m[10] * direction.z);
+        }
+    }
+
+    template<typename T>
+    inline vec3_t<T> support(const basic_box_shape<T>& shape_, const vec3_t<T>& direction)
+    {
+        // same as the mesh objects, direction is rotated to the local space
+        // and the winning corner is transformed back.
+        const auto& e = shape_._half_extents;
+        const auto local_direction = detail::direction_to_local(direction, shape_._model_mtx);
+        const auto corner = vec3_t<T>(
+            local_direction.x < 0 ? -e.x : e.x, 
+            local_direction.y < 0 ? -e.y : e.y, 
+            local_direction.z < 0 ? -e.z : e.z);
+        return transform(corner, shape_._model_mtx);
+    }
+
+    template<typename T>
+    inline vec3_t<T> center(const basic_box_shape<T>& shape_) { return vec3_t<T>(shape_._model_mtx[3], shape_._model_mtx[7], shape_._model_mtx[11]); }
+
+    // mesh objects are one more shape type, support search (cooked hull, SoA kernel, 
+    // primitive) stays in the translation unit. single precision, see the 'rebase_origin' policy.
+    xfloat3 support(const mesh_object& object_, const xfloat3& direction);
+
+    inline xfloat3 center(const mesh_object& object_) { return xfloat3(object_._model_mtx[3], object_._model_mtx[7], object_._model_mtx[11]); }
+
+    // shape adapters, composed purely from the support functions of the operands, no vertices 
+    // are generated. operands are stored by value, shape types are small (or refer to their data).
+    // adapters have the scalar type of their (first) operand.
+
+    // 'Shape' in the space of the model matrix, any linear transform plus translation
+    template<support_shape Shape>
+    struct transformed_shape
+    {
+        using scalar = shape_scalar_t<Shape>;
+
+        mat4_t<scalar>
+        _model_mtx{};
+
+        Shape
+        _shape{};
+    };
+
+    template<support_shape Shape>
+    inline vec3_t<shape_scalar_t<Shape>> support(const transformed_shape<Shape>& shape_, const vec3_t<shape_scalar_t<Shape>>& direction)
+    {
+        const auto local_direction = detail::direction_to_local(direction, shape_._model_mtx);
+        return transform(support(shape_._shape, local_direction), shape_._model_mtx);
+    }
+
+    // minkowski sum A + B, e.g. a box plus a sphere is a rounded (inflated) box
+    template<support_shape ShapeA, support_shape ShapeB>
+    struct minkowski_sum_shape
+    {
+        static_assert(std::is_same_v<shape_scalar_t<ShapeA>, shape_scalar_t<ShapeB>>, "operands must have the same scalar type");
+
+        using scalar = shape_scalar_t<ShapeA>;
+
+        ShapeA
+        _a{};
+
+        ShapeB
+        _b{};
+    };
+
+    template<support_shape ShapeA, support_shape ShapeB>
+    inline vec3_t<shape_scalar_t<ShapeA>> support(const minkowski_sum_shape<ShapeA, ShapeB>& shape_, const vec3_t<shape_scalar_t<ShapeA>>& direction)
+    {
+        return support(shape_._a, direction) + support(shape_._b, direction);
+    }
+
+    // convex hull of A and B, the support point is the better one of the two
+    template<support_shape ShapeA, support_shape ShapeB>
+    struct convex_hull_shape
+    {
+        static_assert(std::is_same_v<shape_scalar_t<ShapeA>, shape_scalar_t<ShapeB>>, "operands must have the same scalar type");
+
+        using scalar = shape_scalar_t<ShapeA>;
+
+        ShapeA
+        _a{};
+
+        ShapeB
+        _b{};
+    };
+
+    template<support_shape ShapeA, support_shape ShapeB>
+    inline vec3_t<shape_scalar_t<ShapeA>> support(const convex_hull_shape<ShapeA, ShapeB>& shape_, const vec3_t<shape_scalar_t<ShapeA>>& direction)
+    {
+        const auto point_a = support(shape_._a, direction);
+        const auto point_b = support(shape_._b, direction);
+        return dot_product(point_a, direction) >= dot_product(point_b, direction) ? point_a : point_b;
+    }
+
+    // volume covered by 'Shape' translating linearly by '_motion', convex hull 
+    // of the start and end placements, e.g. a box swept over the frame's motion.
+    template<support_shape Shape>
+    struct swept_shape
+    {
+        using scalar = shape_scalar_t<Shape>;
+
+        Shape
+        _shape{};
+
+        vec3_t<scalar>
+        _motion{};
+    };
+
+    template<support_shape Shape>
+    inline vec3_t<shape_scalar_t<Shape>> support(const swept_shape<Shape>& shape_, const vec3_t<shape_scalar_t<Shape>>& direction)
+    {
+        const auto point = support(shape_._shape, direction);
+        return dot_product(shape_._motion, direction) > 0 ? point + shape_._motion : point;
+    }
+
+    namespace detail
+    {
+        // simplex vertex of the compile-time path in the kernel vector type 'Vec', witness tracking 
+        // keeps the support points of both shapes. no vertex indices, shape types have no vertices to index.
+        template<typename Vec, bool WITNESS>
+        struct simplex_vertex;
+
+        template<typename Vec>
+        struct simplex_vertex<Vec, false>
+        {
+            Vec
+            _position{};
+        };
+
+        template<typename Vec>
+        struct simplex_vertex<Vec, true>
+        {
+            Vec
+            _position{};
+
+            Vec
+            _support_a{};
+
+            Vec
+            _support_b{};
+        };
+
+        template<typename Shape>
+        inline vec3_t<shape_scalar_t<Shape>> shape_center(const Shape& shape_) 
+        {
+            using vec = vec3_t<shape_scalar_t<Shape>>;
+            if constexpr (requires { { center(shape_) } -> std::convertible_to<vec>; }) {
+                return center(shape_);
+            } else {
+                return vec(0, 0, 0);
+            }
+        }
+
+        // scalar type the points of a pair are combined in, the wider of the two
+        template<typename ShapeA, typename ShapeB>
+        using pair_scalar_t = std::common_type_t<shape_scalar_t<ShapeA>, shape_scalar_t<ShapeB>>;
+
+        // support point of the minkowski difference B - A, the difference is taken in the scalar type 
+        // of the shapes before it is rounded to the kernel type. with double precision shapes 
+        // and a single precision kernel it is as if the pair was rebased to the origin.
+        template<typename Vertex, support_shape ShapeA, support_shape ShapeB>
+        inline Vertex find_minkowski_support(const decltype(Vertex::_position)& search_direction, const ShapeA& alpha_, const ShapeB& beta_)
+        {
+            using vec      = decltype(Vertex::_position);
+            using pair_vec = vec3_t<pair_scalar_t<ShapeA, ShapeB>>;
+
+            const auto support_a = convert_vec3<pair_vec>(support(alpha_, convert_vec3<vec3_t<shape_scalar_t<ShapeA>>>(negate(search_direction))));
+            const auto support_b = convert_vec3<pair_vec>(support(beta_, convert_vec3<vec3_t<shape_scalar_t<ShapeB>>>(search_direction)));
+            const auto position  = convert_vec3<vec>(support_b - support_a);
+            if constexpr (requires(Vertex v) { v._support_a; }) {
+                return Vertex{ position, convert_vec3<vec>(support_a), convert_vec3<vec>(support_b) };
+            } else {
+                return Vertex{ position };
+            }
+        }
+
+        // closest point of a simplex to the origin, '_indices' are the vertices of the supporting 
+        // sub-simplex (ascending) and '_weights' their barycentric coordinates.
+        template<typename Vec>
+        struct basic_simplex_closest_point
+        {
+            Vec
+            _point{};
+
+            vec_scalar_t<Vec>
+            _weights[4]{};
+
+            uint32_t
+            _indices[4]{};
+
+            uint32_t
+            _count{};
+        };
+
+        using simplex_closest_point = basic_simplex_closest_point<xfloat3>;
+
+        template<typename Vec>
+        inline uint32_t major_axis(const Vec& v)
+        {
+            const auto ax = std::abs(v.x), ay = std::abs(v.y), az = std::abs(v.z);
+            return ax >= ay && ax >= az ? 0 : (ay >= az ? 1 : 2);
+        }
+
+        template<typename Vec>
+        inline vec_scalar_t<Vec> component(const Vec& v, const uint32_t axis)
+        {
+            return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+        }
+
+        template<typename T>
+        inline bool same_sign(const T a, const T b)
+        {
+            return (a > 0 && b > 0) || (a < 0 && b < 0);
+        }
+
+        template<typename Vec>
+        inline basic_simplex_closest_point<Vec> single_vertex(const Vec* points, const uint32_t i)
+        {
+            basic_simplex_closest_point<Vec> result{};
+            result._point      = points[i];
+            result._weights[0] = 1;
+            result._indices[0] = i;
+            result._count      = 1;
+            return result;
+        }
+
+        // signed volumes subalgorithm (Montanari, Petrinic, Barbieri 2017), the origin is projected 
+        // on the affine hull of the simplex and its barycentric coordinates are signed volumes 
+        // (lengths, areas) measured on the axis (plane) where the simplex is largest, which 
+        // keeps them accurate for near-degenerate simplices. vertices with a coordinate of the 
+        // wrong sign are dropped and the remaining sub-simplices are searched, no restarts.
+
+        // segment 'i0' => 'i1'
+        template<typename Vec>
+        inline basic_simplex_closest_point<Vec> signed_volumes_1d(const Vec* points, const uint32_t i0, const uint32_t i1)
+        {
+            const auto& a = points[i0];
+            const auto& b = points[i1];
+            const auto  t = b - a;
+            const auto  length_sq = dot_product(t, t);
+            if(length_sq == 0) {
+                return single_vertex(points, i1);
+            }
+
+            const auto projection = a - t * (dot_product(a, t) / length_sq);
+            const auto axis = major_axis(t);
+            const auto mu   = component(b, axis) - component(a, axis);
+            const auto c0   = component(b, axis) - component(projection, axis);
+            const auto c1   = component(projection, axis) - component(a, axis);
+
+            if(same_sign(mu, c0) && same_sign(mu, c1)) {
+                basic_simplex_closest_point<Vec> result{};
+                result._point      = projection;
+                result._weights[0] = c0 / mu;
+                result._weights[1] = c1 / mu;
+                result._indices[0] = i0;
+                result._indices[1] = i1;
+                result._count      = 2;
+                return result;
+            }
+            // projection is past the end with the wrong signed coordinate
+            return single_vertex(points, same_sign(mu, c1) ? i1 : i0);
+        }
+
+        template<typename Vec>
+        inline basic_simplex_closest_point<Vec> closer(const basic_simplex_closest_point<Vec>& a, const basic_simplex_closest_point<Vec>& b)
+        {
+            return dot_product(b._point, b._point) < dot_product(a._point, a._point) ? b : a;
+        }
+
+        template<typename Vec>
+        inline basic_simplex_closest_point<Vec> farthest_closest_point()
+        {
+            constexpr auto max = std::numeric_limits<vec_scalar_t<Vec>>::max();
+            basic_simplex_closest_point<Vec> result{};
+            result._point = Vec(max, max, max);
+            return result;
+        }
+
+        // triangle 'i0', 'i1', 'i2'
+        template<typename Vec>
+        inline basic_simplex_closest_point<Vec> signed_volumes_2d(const Vec* points, const uint32_t i0, const uint32_t i1, const uint32_t i2)
+        {
+            using scalar = vec_scalar_t<Vec>;
+
+            const uint32_t i[3] = {i0, i1, i2};
+            const auto n = cross_product(points[i1] - points[i0], points[i2] - points[i0]);
+            const auto n_sq = dot_product(n, n);
+
+            auto best = farthest_closest_point<Vec>();
+
+            if(n_sq == 0) {
+                // collinear, closest of the edges
+                best = closer(best, signed_volumes_1d(points, i0, i1));
+                best = closer(best, signed_volumes_1d(points, i0, i2));
+                return closer(best, signed_volumes_1d(points, i1, i2));
+            }
+
+            const auto projection = n * (dot_product(points[i0], n) / n_sq);
+
+            // signed areas on the coordinate plane where the projected triangle is largest
+            const auto drop = major_axis(n);
+            const auto u = drop == 0 ? 1u : 0u;
+            const auto v = drop == 2 ? 1u : 2u;
+            const auto area = [&](const Vec& p, const Vec& q, const Vec& r) {
+                return (component(q, u) - component(p, u)) * (component(r, v) - component(p, v)) -
+                       (component(q, v) - component(p, v)) * (component(r, u) - component(p, u));
+            };
+
+            const auto& a = points[i0];
+            const auto& b = points[i1];
+            const auto& c = points[i2];
+            const auto nu = area(a, b, c);
+            const scalar coordinates[3] = { area(projection, b, c), area(a, projection, c), area(a, b, projection) };
+
+            if(same_sign(nu, coordinates[0]) && same_sign(nu, coordinates[1]) && same_sign(nu, coordinates[2])) {
+                basic_simplex_closest_point<Vec> result{};
+                result._point = projection;
+                for(uint32_t k = 0; k < 3; ++k) {
+                    result._weights[k] = coordinates[k] / nu;
+                    result._indices[k] = i[k];
+                }
+                result._count = 3;
+                return result;
+            }
+
+            // closest point is on an edge opposite to a vertex with the wrong signed coordinate
+            constexpr uint32_t edges[3][2] = {{1, 2}, {0, 2}, {0, 1}};
+            for(uint32_t k = 0; k < 3; ++k) {
+                if(!same_sign(nu, coordinates[k])) {
+                    best = closer(best, signed_volumes_1d(points, i[edges[k][0]], i[edges[k][1]]));
+                }
+            }
+            return best;
+        }
+
+        // tetrahedron 0, 1, 2, 3
+        template<typename Vec>
+        inline basic_simplex_closest_point<Vec> signed_volumes_3d(const Vec* points)
+        {
+            using scalar = vec_scalar_t<Vec>;
+
+            const auto volume = [](const Vec& p, const Vec& q, const Vec& r, const Vec& s) {
+                return mixed_product(q - p, r - p, s - p);
+            };
+
+            const auto& a = points[0];
+            const auto& b = points[1];
+            const auto& c = points[2];
+            const auto& d = points[3];
+            const auto origin = Vec(0, 0, 0);
+
+            const auto det = volume(a, b, c, d);
+            const scalar coordinates[4] = { 
+                volume(origin, b, c, d), volume(a, origin, c, d), 
+                volume(a, b, origin, d), volume(a, b, c, origin) };
+
+            if(same_sign(det, coordinates[0]) && same_sign(det, coordinates[1]) && 
+               same_sign(det, coordinates[2]) && same_sign(det, coordinates[3])) {
+                basic_simplex_closest_point<Vec> result{};
+                for(uint32_t k = 0; k < 4; ++k) {
+                    result._weights[k] = coordinates[k] / det;
+                    result._indices[k] = k;
+                }
+                result._count = 4;
+                return result;
+            }
+
+            // faces opposite to the vertices with the wrong signed coordinate, 
+            // all of them when the tetrahedron is flat.
+            constexpr uint32_t faces[4][3] = {{1, 2, 3}, {0, 2, 3}, {0, 1, 3}, {0, 1, 2}};
+
+            auto best = farthest_closest_point<Vec>();
+            for(uint32_t k = 0; k < 4; ++k) {
+                if(det == 0 || !same_sign(det, coordinates[k])) {
+                    best = closer(best, signed_volumes_2d(points, faces[k][0], faces[k][1], faces[k][2]));
+                }
+            }
+            return best;
+        }
+
+        // closest point of a 1-4 point simplex to the origin
+        template<typename Vec>
+        inline basic_simplex_closest_point<Vec> signed_volumes(const Vec* points, const uint32_t count)
+        {
+            switch(count)
+            {
+                case 1:  return single_vertex(points, 0);
+                case 2:  return signed_volumes_1d(points, 0, 1);
+                case 3:  return signed_volumes_2d(points, 0, 1, 2);
+                case 4:  return signed_volumes_3d(points);
+                default: break;
+            }
+            return {};
+        }
+
+        // closest point of the simplex is the origin within the relative tolerance, an absolute 
+        // epsilon would be too strict for large and too loose for small objects.
+        template<typename Vec>
+        inline bool on_simplex(const Vec& closest, const Vec* points, const uint32_t count)
+        {
+            using scalar = vec_scalar_t<Vec>;
+            constexpr auto epsilon = scalar_traits<scalar>::relative_epsilon;
+
+            scalar size_sq = 0;
+            for(uint32_t i = 0; i < count; ++i) {
+                size_sq = std::max(size_sq, dot_product(points[i], points[i]));
+            }
+            return dot_product(closest, closest) <= epsilon * epsilon * size_sq;
+        }
+
+        // new support point is already in the simplex, the search can't make progress
+        template<typename Point, typename Vec>
+        inline bool is_duplicate(const fixed_list<Point, 4>& simplex, const Vec& position)
+        {
+            for(uint32_t i = 0; i < simplex.size(); ++i) {
+                const auto delta = simplex[i]._position - position;
+                if(dot_product(delta, delta) == 0) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // simplex update shared by all the GJK loops, the simplex is reduced to the sub-simplex 
+        // closest to the origin and the next search direction points from it towards the origin.
+        // returns 'true' when the origin is inside (or on the boundary of) the simplex.
+        // 'Point' needs only the '_position' member, of the same type as 'direction'.
+        template<typename Point, typename Vec>
+        inline bool test_simplex(fixed_list<Point, 4>& simplex, Vec& direction)
+        {
+            Vec points[4];
+            for(uint32_t i = 0; i < simplex.size(); ++i) {
+                points[i] = simplex[i]._position;
+            }
+
+            const auto closest = signed_volumes(points, simplex.size());
+            if(closest._count == 4) {
+                // We have encapsulated the origin! 
+                // intersection between objects is happening.
+                return true;
+            }
+
+            fixed_list<Point, 4> reduced{};
+            Vec reduced_points[4];
+            for(uint32_t i = 0; i < closest._count; ++i) {
+                reduced.add(simplex[closest._indices[i]]);
+                reduced_points[i] = points[closest._indices[i]];
+            }
+            simplex = reduced;
+
+            // origin is on the simplex (relative to its size), objects are touching
+            if(on_simplex(closest._point, reduced_points, simplex.size())) {
+                return true;
+            }
+
+            direction = negate(closest._point);
+            return false;
+        }
+    }
+
+    // adapter centers, operands without 'center' count as centered at the origin
+
+    template<support_shape Shape>
+    inline vec3_t<shape_scalar_t<Shape>> center(const transformed_shape<Shape>& shape_) 
+    {
+        return transform(detail::shape_center(shape_._shape), shape_._model_mtx);
+    }
+
+    template<support_shape ShapeA, support_shape ShapeB>
+    inline vec3_t<shape_scalar_t<ShapeA>> center(const minkowski_sum_shape<ShapeA, ShapeB>& shape_) 
+    {
+        return detail::shape_center(shape_._a) + detail::shape_center(shape_._b);
+    }
+
+    template<support_shape ShapeA, support_shape ShapeB>
+    inline vec3_t<shape_scalar_t<ShapeA>> center(const convex_hull_shape<ShapeA, ShapeB>& shape_) 
+    {
+        return (detail::shape_center(shape_._a) + detail::shape_center(shape_._b)) * shape_scalar_t<ShapeA>(0.5);
+    }
+
+    template<support_shape Shape>
+    inline vec3_t<shape_scalar_t<Shape>> center(const swept_shape<Shape>& shape_) 
+    {
+        return detail::shape_center(shape_._shape) + shape_._motion * shape_scalar_t<Shape>(0.5);
+    }
+
+    // boolean GJK test of any two shape types configured by 'Policy', same loop as the 'mesh_object' 
+    // overload without validation or warm start. 'by_products' is required by tracing policies.
+    // the kernel runs in 'Policy::scalar', independent of the scalar type of the shapes, 
+    // see 'detail::find_minkowski_support'.
+    template<typename Policy, support_shape ShapeA, support_shape ShapeB>
+    gjk::result_bits intersects(const ShapeA& alpha_, const ShapeB& beta_, const uint32_t max_iter_ = 100, by_products_data* by_products = nullptr)
+    {
+        using vec      = vec3_t<typename Policy::scalar>;
+        using pair_vec = vec3_t<detail::pair_scalar_t<ShapeA, ShapeB>>;
+        using vertex   = detail::simplex_vertex<vec, Policy::track_witness>;
+
+        fixed_list<vertex, 4> simplex{};
+
+        const auto trace = [&]() {
+            if constexpr (Policy::trace) {
+                fixed_list<xfloat3, 4> store_simplex{};
+                for(uint32_t i = 0; i < simplex.size(); ++i) {
+                    store_simplex.add(convert_vec3<xfloat3>(simplex[i]._position));
+                }
+                by_products->_simplex_construction_buffer.push(store_simplex);
+            }
+        };
+
+        const auto finish = [&](const std::underlying_type<result_bits>::type bits) {
+            if constexpr (Policy::trace) {
+                for(uint32_t i = 0; i < simplex.size(); ++i) {
+                    by_products->_simplex_points.add(convert_vec3<xfloat3>(simplex[i]._position));
+                }
+            }
+            return static_cast<result_bits>(bits);
+        };
+
+        if constexpr (Policy::trace) { by_products->reset(); }
+
+        auto search_direction = convert_vec3<vec>(
+            convert_vec3<pair_vec>(detail::shape_center(beta_)) - convert_vec3<pair_vec>(detail::shape_center(alpha_)));
+        if(dot_product(search_direction, search_direction) == 0) {
+            search_direction = vec(1, 0, 0);
+        }
+
+        const auto initial_support_point = detail::find_minkowski_support<vertex>(search_direction, alpha_, beta_);
+        simplex.add(initial_support_point);
+        trace();
+
+        if(dot_product(initial_support_point._position, search_direction) < 0) {
+            return finish(GJK_EMPTY_MASK);
+        }
+
+        search_direction = negate(initial_support_point._position);
+
+        for(uint32_t iter = 0; iter <= max_iter_; ++iter)
+        {
+            const auto support_point = detail::find_minkowski_support<vertex>(search_direction, alpha_, beta_);
+
+            // we are beyond the origin, early exit
+            if(dot_product(support_point._position, search_direction) < 0) {
+                return finish(GJK_EMPTY_MASK);
+            }
+
+            // stalled on float noise, touching at best
+            if constexpr (Policy::termination == GJK_TERMINATION_RELATIVE) {
+                if(detail::is_duplicate(simplex, support_point._position)) {
+                    return finish(GJK_INTERSECTING_BIT | GJK_NOT_CONVERGED_BIT);
+                }
+            }
+
+            simplex.add(support_point);
+            trace();
+
+            if(detail::test_simplex(simplex, search_direction)) {
+                return finish(GJK_INTERSECTING_BIT);
+            }
+        }
+
+        // 'max_iter_' reached, see the 'mesh_object' overload
+        return finish(GJK_INTERSECTING_BIT | GJK_NOT_CONVERGED_BIT);
+    }
+
+    // boolean GJK test of any two shape types with the position-only kernel, 
+    // in the wider scalar type of the pair.
+    template<support_shape ShapeA, support_shape ShapeB>
+    gjk::result_bits intersects(const ShapeA& alpha_, const ShapeB& beta_, const uint32_t max_iter_ = 100)
+    {
+        using policy = gjk_policy<false, false, detail::pair_scalar_t<ShapeA, ShapeB>>;
+        return gjk::intersects<policy>(alpha_, beta_, max_iter_);
+    }
+
+    // type-erased reference to a shape of the dispatch table
+    struct shape_ref
+    {
+        uint32_t
+        _kind{};
+
+        const void*
+        _shape{};
+    };
+
+    // runtime double-dispatch for heterogeneous scenes, table holds an 'intersects' 
+    // instantiation for every ordered pair of the listed shape types.
+    template<support_shape... Shapes>
+    class shape_dispatch
+    {
+    public:
+        static constexpr uint32_t KIND_COUNT = sizeof...(Shapes);
+
+        using intersects_fn = gjk::result_bits (*)(const void*, const void*, uint32_t);
+
+        // index of the shape type in the table
+        template<typename Shape>
+        static constexpr uint32_t kind_of() 
+        {
+            static_assert((std::same_as<Shape, Shapes> || ...), "shape type is not part of the dispatch table");
+            constexpr bool matches[] = { std::same_as<Shape, Shapes>... };
+            uint32_t kind = 0;
+            while(!matches[kind]) { ++kind; }
+            return kind;
+        }
+
+        template<typename Shape>
+        static constexpr shape_ref make_ref(const Shape& shape_) 
+        {
+            return shape_ref{ kind_of<Shape>(), &shape_ };
+        }
+
+        static gjk::result_bits intersects(const shape_ref& alpha_, const shape_ref& beta_, const uint32_t max_iter_ = 100)
+        {
+            if(alpha_._kind >= KIND_COUNT || beta_._kind >= KIND_COUNT || !alpha_._shape || !beta_._shape) {
+                return static_cast<result_bits>(GJK_INVALID_BIT | GJK_ERROR_NULL_OBJECT_BIT);
+            }
+            return _table[alpha_._kind * KIND_COUNT + beta_._kind](alpha_._shape, beta_._shape, max_iter_);
+        }
+
+    private:
+        template<typename ShapeA, typename ShapeB>
+        static gjk::result_bits intersects_erased(const void* alpha_, const void* beta_, uint32_t max_iter_)
+        {
+            return gjk::intersects(*static_cast<const ShapeA*>(alpha_), *static_cast<const ShapeB*>(beta_), max_iter_);
+        }
+
+        template<typename ShapeA>
+        static constexpr void fill_row(intersects_fn*& out) 
+        {
+            ((*out++ = &intersects_erased<ShapeA, Shapes>), ...);
+        }
+
+        static constexpr auto build_table() 
+        {
+            std::array<intersects_fn, KIND_COUNT * KIND_COUNT> table{};
+            auto out = table.data();
+            (fill_row<Shapes>(out), ...);
+            return table;
+        }
+
+        static constexpr std::array<intersects_fn, KIND_COUNT * KIND_COUNT> _table = build_table();
+    };
+
+    // dispatch table of the built-in shape types
+    using default_shape_dispatch = shape_dispatch<sphere_shape, capsule_shape, box_shape, mesh_object>;
+};
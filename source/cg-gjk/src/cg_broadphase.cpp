@@ -0,0 +1,1161 @@
+///////////////////////////////////////////////////////////////////
+// Broadphase, candidate pairs for the GJK narrowphase
+///////////////////////////////////////////////////////////////////
+
+#include "cg_broadphase.hpp"
+#include "cg_gjk_shapes.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+using namespace s2cpp;
+using namespace mxlib;
+
+static gjk::aabb empty_bounds()
+{
+    constexpr auto max = std::numeric_limits<float>::max();
+    return gjk::aabb{ xfloat3(max, max, max), xfloat3(-max, -max, -max) };
+}
+
+gjk::aabb gjk::world_bounds(const mesh_object& object_)
+{
+    const auto has_shape =
+        object_._primitive._type != GJK_PRIMITIVE_NONE ||
+        object_._convex_shape ||
+        (object_._vertices && object_._vertex_count > 0);
+    if(!has_shape) {
+        return empty_bounds();
+    }
+
+    if(bounds_cache scratch{}; const auto bounds = object_bounds(object_, scratch)) {
+        return bounds->_box;
+    }
+
+    // the support point along an axis is the extreme of the object on it
+    return aabb{
+        xfloat3(
+            support(object_, xfloat3(-1, 0, 0)).x,
+            support(object_, xfloat3(0, -1, 0)).y,
+            support(object_, xfloat3(0, 0, -1)).z),
+        xfloat3(
+            support(object_, xfloat3(1, 0, 0)).x,
+            support(object_, xfloat3(0, 1, 0)).y,
+            support(object_, xfloat3(0, 0, 1)).z)
+    };
+}
+
+void gjk::sweep_and_prune::resize(const uint32_t count)
+{
+    const auto previous = static_cast<uint32_t>(_bounds.size());
+    if(count == previous) {
+        return;
+    }
+
+    _bounds.resize(count, empty_bounds());
+
+    // drop the endpoints of removed proxies, append the new ones (sorted on the next update)
+    if(count < previous) {
+        std::erase_if(_endpoints, [count](const endpoint& e) { return (e._proxy & ~MAX_BIT) >= count; });
+    }
+    for(uint32_t i = previous; i < count; ++i) {
+        _endpoints.push_back(endpoint{ 0, i });
+        _endpoints.push_back(endpoint{ 0, i | MAX_BIT });
+    }
+}
+
+void gjk::sweep_and_prune::sort_endpoints()
+{
+    for(auto& e : _endpoints) {
+        const auto& box = _bounds[e._proxy & ~MAX_BIT];
+        e._value = (e._proxy & MAX_BIT) ? box._max.x : box._min.x;
+    }
+
+    // min endpoints go first on ties so touching boxes are swept as overlapping
+    const auto less = [](const endpoint& a, const endpoint& b) {
+        return a._value < b._value || (a._value == b._value && !(a._proxy & MAX_BIT) && (b._proxy & MAX_BIT));
+    };
+
+    // insertion sort, nearly sorted from the last frame
+    for(size_t i = 1; i < _endpoints.size(); ++i) {
+        const auto e = _endpoints[i];
+        auto j = i;
+        while(j > 0 && less(e, _endpoints[j - 1])) {
+            _endpoints[j] = _endpoints[j - 1];
+            --j;
+        }
+        _endpoints[j] = e;
+    }
+}
+
+void gjk::sweep_and_prune::update(std::span<const mesh_object> objects_)
+{
+    resize(static_cast<uint32_t>(objects_.size()));
+    for(size_t i = 0; i < objects_.size(); ++i) {
+        _bounds[i] = world_bounds(objects_[i]);
+    }
+    sort_endpoints();
+}
+
+void gjk::sweep_and_prune::update(std::span<const aabb> bounds_)
+{
+    resize(static_cast<uint32_t>(bounds_.size()));
+    std::copy(bounds_.begin(), bounds_.end(), _bounds.begin());
+    sort_endpoints();
+}
+
+void gjk::sweep_and_prune::find_pairs(std::vector<object_pair>& pairs_) const
+{
+    _active.clear();
+
+    for(const auto& e : _endpoints) {
+        const auto proxy = e._proxy & ~MAX_BIT;
+        const auto& box = _bounds[proxy];
+
+        if(e._proxy & MAX_BIT) {
+            const auto it = std::find(_active.begin(), _active.end(), proxy);
+            if(it != _active.end()) {
+                *it = _active.back();
+                _active.pop_back();
+            }
+            continue;
+        }
+
+        // empty boxes are never active
+        if(box._min.x > box._max.x) {
+            continue;
+        }
+
+        // x overlaps with every active proxy, test the remaining axes
+        for(const auto other : _active) {
+            const auto& other_box = _bounds[other];
+            if(box._min.y <= other_box._max.y && other_box._min.y <= box._max.y &&
+               box._min.z <= other_box._max.z && other_box._min.z <= box._max.z) {
+                pairs_.push_back(object_pair{ std::min(proxy, other), std::max(proxy, other) });
+            }
+        }
+        _active.push_back(proxy);
+    }
+}
+
+// traversal stack of the tree queries
+constexpr uint32_t GJK_AABB_TREE_STACK_SIZE = 256;
+
+static gjk::aabb fatten(const gjk::aabb& box, const float margin)
+{
+    const auto m = xfloat3(margin, margin, margin);
+    return gjk::aabb{ box._min - m, box._max + m };
+}
+
+uint32_t gjk::dynamic_aabb_tree::allocate_node()
+{
+    if(_free_list == NULL_NODE) {
+        _nodes.push_back(node{});
+        _nodes.back()._height = 0;
+        return static_cast<uint32_t>(_nodes.size() - 1);
+    }
+
+    const auto index = _free_list;
+    _free_list = _nodes[index]._parent;
+    _nodes[index] = node{};
+    _nodes[index]._height = 0;
+    return index;
+}
+
+void gjk::dynamic_aabb_tree::free_node(const uint32_t index)
+{
+    _nodes[index]._parent = _free_list;
+    _nodes[index]._height = -1;
+    _free_list = index;
+}
+
+// box and height of 'index' from its children
+void gjk::dynamic_aabb_tree::refit(uint32_t index)
+{
+    auto& n = _nodes[index];
+    const auto& c0 = _nodes[n._child[0]];
+    const auto& c1 = _nodes[n._child[1]];
+    n._box    = merge(c0._box, c1._box);
+    n._height = 1 + std::max(c0._height, c1._height);
+}
+
+// rotates the taller grandchild up when the children of 'a' differ in height by more 
+// than one, returns the root of the subtree.
+uint32_t gjk::dynamic_aabb_tree::balance(const uint32_t a)
+{
+    if(_nodes[a].is_leaf() || _nodes[a]._height < 2) {
+        return a;
+    }
+
+    const auto b = _nodes[a]._child[0];
+    const auto c = _nodes[a]._child[1];
+    const auto difference = _nodes[c]._height - _nodes[b]._height;
+    if(difference >= -1 && difference <= 1) {
+        return a;
+    }
+
+    // 'up' replaces 'a', 'a' keeps its other child and the shorter child of 'up'
+    const auto side = difference > 1 ? 1 : 0;
+    const auto up   = _nodes[a]._child[side];
+    const auto f    = _nodes[up]._child[0];
+    const auto g    = _nodes[up]._child[1];
+
+    _nodes[up]._child[0] = a;
+    _nodes[up]._parent   = _nodes[a]._parent;
+    _nodes[a]._parent    = up;
+
+    if(const auto parent = _nodes[up]._parent; parent != NULL_NODE) {
+        auto& p = _nodes[parent];
+        p._child[p._child[0] == a ? 0 : 1] = up;
+    } else {
+        _root = up;
+    }
+
+    const auto taller  = _nodes[f]._height > _nodes[g]._height ? f : g;
+    const auto shorter = taller == f ? g : f;
+    _nodes[up]._child[1]   = taller;
+    _nodes[a]._child[side] = shorter;
+    _nodes[shorter]._parent = a;
+
+    refit(a);
+    refit(up);
+    return up;
+}
+
+void gjk::dynamic_aabb_tree::insert_leaf(const uint32_t leaf)
+{
+    if(_root == NULL_NODE) {
+        _root = leaf;
+        _nodes[leaf]._parent = NULL_NODE;
+        return;
+    }
+
+    // best sibling by the surface area heuristic, descend while a child is cheaper 
+    // than pairing with the current node, 'inherited' is the growth of the ancestors.
+    const auto leaf_box = _nodes[leaf]._box;
+    auto index = _root;
+    while(!_nodes[index].is_leaf()) {
+        const auto& n = _nodes[index];
+        const auto area     = half_area(n._box);
+        const auto combined = half_area(merge(n._box, leaf_box));
+
+        const auto cost      = 2 * combined;
+        const auto inherited = 2 * (combined - area);
+
+        const auto child_cost = [&](const uint32_t child) {
+            const auto& c = _nodes[child];
+            const auto grown = half_area(merge(c._box, leaf_box));
+            return (c.is_leaf() ? grown : grown - half_area(c._box)) + inherited;
+        };
+
+        const auto cost0 = child_cost(n._child[0]);
+        const auto cost1 = child_cost(n._child[1]);
+        if(cost < cost0 && cost < cost1) {
+            break;
+        }
+        index = cost0 < cost1 ? n._child[0] : n._child[1];
+    }
+
+    const auto sibling    = index;
+    const auto old_parent = _nodes[sibling]._parent;
+    const auto new_parent = allocate_node();
+
+    auto& p = _nodes[new_parent];
+    p._parent   = old_parent;
+    p._box      = merge(leaf_box, _nodes[sibling]._box);
+    p._height   = _nodes[sibling]._height + 1;
+    p._child[0] = sibling;
+    p._child[1] = leaf;
+    _nodes[sibling]._parent = new_parent;
+    _nodes[leaf]._parent    = new_parent;
+
+    if(old_parent != NULL_NODE) {
+        auto& op = _nodes[old_parent];
+        op._child[op._child[0] == sibling ? 0 : 1] = new_parent;
+    } else {
+        _root = new_parent;
+    }
+
+    // refit and rebalance the ancestors
+    for(index = _nodes[leaf]._parent; index != NULL_NODE; index = _nodes[index]._parent) {
+        index = balance(index);
+        refit(index);
+    }
+}
+
+void gjk::dynamic_aabb_tree::remove_leaf(const uint32_t leaf)
+{
+    if(leaf == _root) {
+        _root = NULL_NODE;
+        return;
+    }
+
+    const auto parent      = _nodes[leaf]._parent;
+    const auto grandparent = _nodes[parent]._parent;
+    const auto sibling     = _nodes[parent]._child[_nodes[parent]._child[0] == leaf ? 1 : 0];
+
+    free_node(parent);
+    _nodes[sibling]._parent = grandparent;
+
+    if(grandparent == NULL_NODE) {
+        _root = sibling;
+        return;
+    }
+
+    auto& g = _nodes[grandparent];
+    g._child[g._child[0] == parent ? 0 : 1] = sibling;
+
+    for(auto index = grandparent; index != NULL_NODE; index = _nodes[index]._parent) {
+        index = balance(index);
+        refit(index);
+    }
+}
+
+uint32_t gjk::dynamic_aabb_tree::create_proxy(const aabb& bounds_, const uint32_t user_)
+{
+    const auto proxy = allocate_node();
+    _nodes[proxy]._box  = fatten(bounds_, _margin);
+    _nodes[proxy]._user = user_;
+    insert_leaf(proxy);
+    ++_proxy_count;
+    return proxy;
+}
+
+void gjk::dynamic_aabb_tree::destroy_proxy(const uint32_t proxy_)
+{
+    remove_leaf(proxy_);
+    free_node(proxy_);
+    --_proxy_count;
+}
+
+bool gjk::dynamic_aabb_tree::move_proxy(const uint32_t proxy_, const aabb& bounds_)
+{
+    if(encloses(_nodes[proxy_]._box, bounds_)) {
+        return false;
+    }
+
+    remove_leaf(proxy_);
+    _nodes[proxy_]._box = fatten(bounds_, _margin);
+    insert_leaf(proxy_);
+    return true;
+}
+
+void gjk::dynamic_aabb_tree::update(std::span<const mesh_object> objects_)
+{
+    const auto count = static_cast<uint32_t>(objects_.size());
+
+    while(_object_proxies.size() > count) {
+        destroy_proxy(_object_proxies.back());
+        _object_proxies.pop_back();
+    }
+
+    for(uint32_t i = 0; i < count; ++i) {
+        const auto bounds = world_bounds(objects_[i]);
+        if(i < _object_proxies.size()) {
+            move_proxy(_object_proxies[i], bounds);
+        } else {
+            _object_proxies.push_back(create_proxy(bounds, i));
+        }
+    }
+}
+
+void gjk::dynamic_aabb_tree::cross_pairs(const uint32_t a, const uint32_t b, std::vector<object_pair>& pairs_) const
+{
+    const auto& na = _nodes[a];
+    const auto& nb = _nodes[b];
+    if(!overlaps(na._box, nb._box)) {
+        return;
+    }
+
+    if(na.is_leaf() && nb.is_leaf()) {
+        pairs_.push_back(object_pair{ std::min(na._user, nb._user), std::max(na._user, nb._user) });
+        return;
+    }
+
+    // descend the larger (internal) node
+    if(nb.is_leaf() || (!na.is_leaf() && half_area(na._box) >= half_area(nb._box))) {
+        cross_pairs(na._child[0], b, pairs_);
+        cross_pairs(na._child[1], b, pairs_);
+    } else {
+        cross_pairs(a, nb._child[0], pairs_);
+        cross_pairs(a, nb._child[1], pairs_);
+    }
+}
+
+void gjk::dynamic_aabb_tree::self_pairs(const uint32_t index, std::vector<object_pair>& pairs_) const
+{
+    const auto& n = _nodes[index];
+    if(n.is_leaf()) {
+        return;
+    }
+    self_pairs(n._child[0], pairs_);
+    self_pairs(n._child[1], pairs_);
+    cross_pairs(n._child[0], n._child[1], pairs_);
+}
+
+void gjk::dynamic_aabb_tree::find_pairs(std::vector<object_pair>& pairs_) const
+{
+    if(_root != NULL_NODE) {
+        self_pairs(_root, pairs_);
+    }
+}
+
+void gjk::dynamic_aabb_tree::query(const aabb& bounds_, std::vector<uint32_t>& users_) const
+{
+    if(_root == NULL_NODE) {
+        return;
+    }
+
+    // balanced, the pending nodes stay far below the capacity
+    uint32_t stack[GJK_AABB_TREE_STACK_SIZE];
+    uint32_t stack_size = 0;
+    stack[stack_size++] = _root;
+
+    while(stack_size > 0) {
+        const auto index = stack[--stack_size];
+
+        const auto& n = _nodes[index];
+        if(!overlaps(n._box, bounds_)) {
+            continue;
+        }
+        if(n.is_leaf()) {
+            users_.push_back(n._user);
+            continue;
+        }
+        assert(stack_size + 2 <= GJK_AABB_TREE_STACK_SIZE);
+        stack[stack_size++] = n._child[0];
+        stack[stack_size++] = n._child[1];
+    }
+}
+
+gjk::task_pool::task_pool(const uint32_t thread_count_)
+{
+    const auto threads = thread_count_ ? thread_count_ : std::max(1u, std::thread::hardware_concurrency());
+    _workers.reserve(threads - 1);
+    for(uint32_t t = 1; t < threads; ++t) {
+        _workers.emplace_back([this]() { worker_loop(); });
+    }
+}
+
+gjk::task_pool::~task_pool()
+{
+    {
+        std::lock_guard lock(_mutex);
+        _stop = true;
+    }
+    _wake.notify_all();
+    for(auto& worker : _workers) {
+        worker.join();
+    }
+}
+
+// takes task indices until the run is out of them
+void gjk::task_pool::drain()
+{
+    for(auto i = _next_task.fetch_add(1); i < _task_count; i = _next_task.fetch_add(1)) {
+        (*_task)(i);
+    }
+}
+
+void gjk::task_pool::worker_loop()
+{
+    uint64_t seen = 0;
+    while(true) {
+        {
+            std::unique_lock lock(_mutex);
+            _wake.wait(lock, [&]() { return _stop || _generation != seen; });
+            if(_stop) {
+                return;
+            }
+            seen = _generation;
+        }
+
+        drain();
+
+        std::lock_guard lock(_mutex);
+        if(--_busy_workers == 0) {
+            _done.notify_one();
+        }
+    }
+}
+
+void gjk::task_pool::run(const uint32_t task_count_, const std::function<void(uint32_t)>& task_)
+{
+    if(_workers.empty() || task_count_ <= 1) {
+        for(uint32_t i = 0; i < task_count_; ++i) {
+            task_(i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard lock(_mutex);
+        _task         = &task_;
+        _task_count   = task_count_;
+        _next_task    = 0;
+        _busy_workers = static_cast<uint32_t>(_workers.size());
+        ++_generation;
+    }
+    _wake.notify_all();
+
+    drain();
+
+    std::unique_lock lock(_mutex);
+    _done.wait(lock, [&]() { return _busy_workers == 0; });
+    _task = nullptr;
+}
+
+// runs 'fn(chunk, begin, end)' over 'count' items split in contiguous chunks on the pool, 
+// at most one chunk per pool thread and no chunks smaller than 'MIN_CHUNK' items.
+template<typename Fn>
+static void parallel_for(gjk::task_pool& pool, const uint32_t count, Fn&& fn)
+{
+    constexpr uint32_t MIN_CHUNK = 256;
+
+    const auto chunks = std::max(1u, std::min(pool.thread_count(), (count + MIN_CHUNK - 1) / MIN_CHUNK));
+    const auto chunk  = (count + chunks - 1) / chunks;
+    pool.run(chunks, [&](const uint32_t c) {
+        fn(c, std::min(c * chunk, count), std::min((c + 1) * chunk, count));
+    });
+}
+
+// in place inclusive prefix sum on the pool, the chunk totals of a first pass are 
+// scanned serially (one per pool thread) and offset the chunks of the second pass.
+static void parallel_inclusive_scan(gjk::task_pool& pool, std::span<uint32_t> values, std::vector<uint32_t>& chunk_sums)
+{
+    const auto count = static_cast<uint32_t>(values.size());
+    chunk_sums.assign(pool.thread_count() + 1, 0);
+    parallel_for(pool, count, [&](const uint32_t chunk, const uint32_t begin, const uint32_t end) {
+        uint32_t sum = 0;
+        for(auto i = begin; i < end; ++i) {
+            sum += values[i];
+        }
+        chunk_sums[chunk + 1] = sum;
+    });
+    for(size_t chunk = 1; chunk < chunk_sums.size(); ++chunk) {
+        chunk_sums[chunk] += chunk_sums[chunk - 1];
+    }
+    parallel_for(pool, count, [&](const uint32_t chunk, const uint32_t begin, const uint32_t end) {
+        auto sum = chunk_sums[chunk];
+        for(auto i = begin; i < end; ++i) {
+            sum += values[i];
+            values[i] = sum;
+        }
+    });
+}
+
+// cell coordinates of the grid level, 20 bits each, wrapped cells share keys 
+// and are told apart by the bounds tests.
+static uint64_t cell_key(const uint32_t level, const int32_t x, const int32_t y, const int32_t z)
+{
+    constexpr uint64_t mask = 0xFFFFF;
+    return (static_cast<uint64_t>(level) << 60) | 
+           ((static_cast<uint64_t>(x) & mask) << 40) | 
+           ((static_cast<uint64_t>(y) & mask) << 20) | 
+            (static_cast<uint64_t>(z) & mask);
+}
+
+static int32_t cell_coordinate(const float value, const float size)
+{
+    return static_cast<int32_t>(std::floor(value / size));
+}
+
+gjk::spatial_hash_grid::spatial_hash_grid(const float cell_size_, const uint32_t thread_count_) :
+    _cell_size(cell_size_),
+    _pool(std::make_unique<task_pool>(thread_count_))
+{
+}
+
+uint32_t gjk::spatial_hash_grid::level_of(const aabb& box) const
+{
+    const auto d = box._max - box._min;
+    const auto extent = std::max(d.x, std::max(d.y, d.z));
+
+    uint32_t level = 0;
+    while(level + 1 < GJK_HASH_GRID_LEVELS && extent > cell_size(level)) {
+        ++level;
+    }
+    return level;
+}
+
+uint32_t gjk::spatial_hash_grid::bucket_of(const uint64_t key) const
+{
+    // fibonacci hashing, top bits of the product
+    return static_cast<uint32_t>((key * 0x9E3779B97F4A7C15ull) >> _bucket_shift);
+}
+
+void gjk::spatial_hash_grid::update(std::span<const mesh_object> objects_)
+{
+    _bounds.resize(objects_.size());
+    parallel_for(*_pool, static_cast<uint32_t>(objects_.size()), [&](uint32_t, const uint32_t begin, const uint32_t end) {
+        for(auto i = begin; i < end; ++i) {
+            _bounds[i] = world_bounds(objects_[i]);
+        }
+    });
+    build();
+}
+
+void gjk::spatial_hash_grid::update(std::span<const aabb> bounds_)
+{
+    _bounds.assign(bounds_.begin(), bounds_.end());
+    build();
+}
+
+void gjk::spatial_hash_grid::build()
+{
+    const auto object_count = static_cast<uint32_t>(_bounds.size());
+
+    // levels and overlapped cell counts
+    _levels.resize(object_count);
+    _entry_offsets.resize(object_count + 1);
+    parallel_for(*_pool, object_count, [&](uint32_t, const uint32_t begin, const uint32_t end) {
+        for(auto i = begin; i < end; ++i) {
+            const auto& box = _bounds[i];
+            if(box._min.x > box._max.x) {
+                _levels[i] = 0;
+                _entry_offsets[i + 1] = 0;
+                continue;
+            }
+            const auto level = level_of(box);
+            const auto size  = cell_size(level);
+            _levels[i] = static_cast<uint8_t>(level);
+            _entry_offsets[i + 1] = 
+                (cell_coordinate(box._max.x, size) - cell_coordinate(box._min.x, size) + 1) * 
+                (cell_coordinate(box._max.y, size) - cell_coordinate(box._min.y, size) + 1) * 
+                (cell_coordinate(box._max.z, size) - cell_coordinate(box._min.z, size) + 1);
+        }
+    });
+
+    _entry_offsets[0] = 0;
+    parallel_inclusive_scan(*_pool, std::span<uint32_t>(_entry_offsets).subspan(1), _scan_sums);
+    const auto entry_count = _entry_offsets[object_count];
+
+    // power of two buckets, about two per entry up to the cap
+    uint32_t bucket_bits = 4;
+    while((1u << bucket_bits) < 2 * entry_count && bucket_bits < GJK_HASH_GRID_MAX_BUCKET_BITS) {
+        ++bucket_bits;
+    }
+    const auto bucket_count = 1u << bucket_bits;
+    _bucket_shift = 64 - bucket_bits;
+
+    _entries.resize(entry_count);
+    parallel_for(*_pool, object_count, [&](uint32_t, const uint32_t begin, const uint32_t end) {
+        for(auto i = begin; i < end; ++i) {
+            if(_entry_offsets[i] == _entry_offsets[i + 1]) {
+                continue;
+            }
+            const auto& box = _bounds[i];
+            const auto level = _levels[i];
+            const auto size  = cell_size(level);
+            auto out = _entries.data() + _entry_offsets[i];
+            for(auto x = cell_coordinate(box._min.x, size); x <= cell_coordinate(box._max.x, size); ++x) {
+                for(auto y = cell_coordinate(box._min.y, size); y <= cell_coordinate(box._max.y, size); ++y) {
+                    for(auto z = cell_coordinate(box._min.z, size); z <= cell_coordinate(box._max.z, size); ++z) {
+                        *out++ = cell_entry{ cell_key(level, x, y, z), i };
+                    }
+                }
+            }
+        }
+    });
+
+    // parallel counting sort by bucket, one task per pool thread, each with the histogram of 
+    // its contiguous entry chunk. the bucket major prefix sum gives every task its scatter 
+    // offsets, the sort is stable. the prefix sum runs over bucket ranges on the pool, 
+    // the range totals are scanned first.
+    const auto tasks = _pool->thread_count();
+    const auto chunk = (entry_count + tasks - 1) / tasks;
+
+    _histograms.assign(static_cast<size_t>(tasks) * bucket_count, 0);
+    _pool->run(tasks, [&](const uint32_t t) {
+        auto histogram = _histograms.data() + static_cast<size_t>(t) * bucket_count;
+        for(auto e = t * chunk; e < std::min((t + 1) * chunk, entry_count); ++e) {
+            ++histogram[bucket_of(_entries[e]._key)];
+        }
+    });
+
+    _scan_sums.assign(_pool->thread_count() + 1, 0);
+    parallel_for(*_pool, bucket_count, [&](const uint32_t range, const uint32_t begin, const uint32_t end) {
+        uint32_t sum = 0;
+        for(uint32_t t = 0; t < tasks; ++t) {
+            const auto histogram = _histograms.data() + static_cast<size_t>(t) * bucket_count;
+            for(auto b = begin; b < end; ++b) {
+                sum += histogram[b];
+            }
+        }
+        _scan_sums[range + 1] = sum;
+    });
+    for(size_t range = 1; range < _scan_sums.size(); ++range) {
+        _scan_sums[range] += _scan_sums[range - 1];
+    }
+
+    _bucket_start.resize(bucket_count + 1);
+    parallel_for(*_pool, bucket_count, [&](const uint32_t range, const uint32_t begin, const uint32_t end) {
+        auto offset = _scan_sums[range];
+        for(auto b = begin; b < end; ++b) {
+            _bucket_start[b] = offset;
+            for(uint32_t t = 0; t < tasks; ++t) {
+                auto& count = _histograms[static_cast<size_t>(t) * bucket_count + b];
+                const auto n = count;
+                count   = offset;
+                offset += n;
+            }
+        }
+    });
+    _bucket_start[bucket_count] = entry_count;
+
+    _sorted_entries.resize(entry_count);
+    _pool->run(tasks, [&](const uint32_t t) {
+        auto histogram = _histograms.data() + static_cast<size_t>(t) * bucket_count;
+        for(auto e = t * chunk; e < std::min((t + 1) * chunk, entry_count); ++e) {
+            _sorted_entries[histogram[bucket_of(_entries[e]._key)]++] = _entries[e];
+        }
+    });
+}
+
+void gjk::spatial_hash_grid::find_pairs(std::vector<object_pair>& pairs_) const
+{
+    const auto object_count = static_cast<uint32_t>(_bounds.size());
+    if(_bucket_start.empty()) {
+        return;
+    }
+
+    _thread_pairs.resize(_pool->thread_count());
+    for(auto& pairs : _thread_pairs) {
+        pairs.clear();
+    }
+
+    // every object looks up the cells of its own and the coarser levels, a pair is reported 
+    // by the finer object (lower index on the same level) in the cell of the coarser level 
+    // holding the min corner of the overlap, so it comes out exactly once.
+    parallel_for(*_pool, object_count, [&](const uint32_t chunk, const uint32_t begin, const uint32_t end) {
+        auto& out = _thread_pairs[chunk];
+        for(auto a = begin; a < end; ++a) {
+            const auto& box = _bounds[a];
+            if(box._min.x > box._max.x) {
+                continue;
+            }
+
+            for(uint32_t level = _levels[a]; level < GJK_HASH_GRID_LEVELS; ++level) {
+                const auto size = cell_size(level);
+                const auto x0 = cell_coordinate(box._min.x, size), x1 = cell_coordinate(box._max.x, size);
+                const auto y0 = cell_coordinate(box._min.y, size), y1 = cell_coordinate(box._max.y, size);
+                const auto z0 = cell_coordinate(box._min.z, size), z1 = cell_coordinate(box._max.z, size);
+
+                for(auto x = x0; x <= x1; ++x) {
+                    for(auto y = y0; y <= y1; ++y) {
+                        for(auto z = z0; z <= z1; ++z) {
+                            const auto key    = cell_key(level, x, y, z);
+                            const auto bucket = bucket_of(key);
+                            for(auto e = _bucket_start[bucket]; e < _bucket_start[bucket + 1]; ++e) {
+                                const auto& entry = _sorted_entries[e];
+                                const auto b = entry._object;
+                                if(entry._key != key || (level == _levels[a] && b <= a)) {
+                                    continue;
+                                }
+
+                                const auto& other = _bounds[b];
+                                if(!overlaps(box, other)) {
+                                    continue;
+                                }
+
+                                const auto corner = xfloat3(
+                                    std::max(box._min.x, other._min.x), 
+                                    std::max(box._min.y, other._min.y), 
+                                    std::max(box._min.z, other._min.z));
+                                if(cell_coordinate(corner.x, size) == x && 
+                                   cell_coordinate(corner.y, size) == y && 
+                                   cell_coordinate(corner.z, size) == z) {
+                                    out.push_back(object_pair{ std::min(a, b), std::max(a, b) });
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    });
+
+    for(const auto& pairs : _thread_pairs) {
+        pairs_.insert(pairs_.end(), pairs.begin(), pairs.end());
+    }
+}
+
+struct gjk::static_bvh::build_node
+{
+    aabb
+    _box{};
+
+    std::unique_ptr<build_node>
+    _child[2]{};
+
+    // primitive range of leaves
+    uint32_t
+    _begin{};
+
+    uint32_t
+    _count{};
+};
+
+// traversal stack of the BVH queries, two entries per level at most
+constexpr uint32_t GJK_BVH_STACK_SIZE = 2 * gjk::GJK_BVH_MAX_DEPTH + 2;
+
+// ranges with fewer primitives are binned on one thread and built as one task
+constexpr uint32_t GJK_BVH_PARALLEL_MIN_PRIMITIVES = 4096;
+
+// bounds of a primitive range and of its centroids
+struct bvh_range_bounds
+{
+    gjk::aabb
+    _box{};
+
+    gjk::aabb
+    _centroid_box{};
+
+    uint32_t
+    _count{};
+};
+
+struct bvh_bin
+{
+    gjk::aabb
+    _box{};
+
+    uint32_t
+    _count{};
+};
+
+// SAH bins of the three axes over the centroid bounds of a range
+struct bvh_bins
+{
+    bvh_bin
+    _axis[3][gjk::GJK_BVH_BIN_COUNT]{};
+};
+
+static void merge_into(bvh_range_bounds& into, const bvh_range_bounds& from)
+{
+    if(from._count == 0) {
+        return;
+    }
+    into._box          = into._count ? gjk::merge(into._box, from._box) : from._box;
+    into._centroid_box = into._count ? gjk::merge(into._centroid_box, from._centroid_box) : from._centroid_box;
+    into._count       += from._count;
+}
+
+static void merge_into(bvh_bins& into, const bvh_bins& from)
+{
+    for(uint32_t axis = 0; axis < 3; ++axis) {
+        for(uint32_t k = 0; k < gjk::GJK_BVH_BIN_COUNT; ++k) {
+            auto& bin = into._axis[axis][k];
+            const auto& other = from._axis[axis][k];
+            if(other._count) {
+                bin._box    = bin._count ? gjk::merge(bin._box, other._box) : other._box;
+                bin._count += other._count;
+            }
+        }
+    }
+}
+
+// 'fn(begin, end)' over the range, split in primitive chunks on the pool when there is one. 
+// the partial results are merged in chunk order.
+template<typename Result, typename Fn>
+static Result reduce_range(gjk::task_pool* pool, const uint32_t begin, const uint32_t end, Fn&& fn)
+{
+    if(!pool) {
+        return fn(begin, end);
+    }
+    std::vector<Result> partial(pool->thread_count());
+    parallel_for(*pool, end - begin, [&](const uint32_t chunk, const uint32_t chunk_begin, const uint32_t chunk_end) {
+        partial[chunk] = fn(begin + chunk_begin, begin + chunk_end);
+    });
+    Result result{};
+    for(const auto& p : partial) {
+        merge_into(result, p);
+    }
+    return result;
+}
+
+gjk::static_bvh::static_bvh(const uint32_t thread_count_) :
+    _pool(std::make_unique<task_pool>(thread_count_))
+{
+}
+
+void gjk::static_bvh::build(std::span<const mesh_object> objects_)
+{
+    std::vector<aabb> bounds(objects_.size());
+    parallel_for(*_pool, static_cast<uint32_t>(objects_.size()), [&](uint32_t, const uint32_t begin, const uint32_t end) {
+        for(auto i = begin; i < end; ++i) {
+            bounds[i] = world_bounds(objects_[i]);
+        }
+    });
+    build(bounds);
+}
+
+void gjk::static_bvh::build(std::span<const aabb> bounds_)
+{
+    _nodes.clear();
+    _primitive_indices.clear();
+
+    // empty boxes are left out
+    _bounds.assign(bounds_.begin(), bounds_.end());
+    _centroids.resize(_bounds.size());
+    for(uint32_t i = 0; i < _bounds.size(); ++i) {
+        const auto& box = _bounds[i];
+        if(box._min.x <= box._max.x) {
+            _centroids[i] = (box._min + box._max) * 0.5f;
+            _primitive_indices.push_back(i);
+        }
+    }
+
+    if(!_primitive_indices.empty()) 
+    {
+        // the top levels are split breadth first with the binning spread over the pool, until 
+        // there are a few subtrees per thread. the subtrees are then built one per task, 
+        // largest first. their primitive ranges are disjoint.
+        struct subtree
+        {
+            std::unique_ptr<build_node>* _slot;
+            uint32_t                     _begin;
+            uint32_t                     _end;
+            uint32_t                     _depth;
+        };
+
+        std::unique_ptr<build_node> root{};
+        std::vector<subtree> frontier{ { &root, 0, static_cast<uint32_t>(_primitive_indices.size()), 0 } };
+        std::vector<subtree> subtrees{};
+        const auto target = 2 * static_cast<size_t>(_pool->thread_count());
+
+        for(size_t next = 0; next < frontier.size(); ++next) 
+        {
+            const auto range = frontier[next];
+            const auto open  = subtrees.size() + frontier.size() - next;
+            if(range._end - range._begin < GJK_BVH_PARALLEL_MIN_PRIMITIVES || open >= target) {
+                subtrees.push_back(range);
+                continue;
+            }
+
+            auto node = std::make_unique<build_node>();
+            const auto middle = split_range(*node, range._begin, range._end, range._depth, _pool.get());
+            if(middle != range._end) {
+                frontier.push_back({ &node->_child[0], range._begin, middle, range._depth + 1 });
+                frontier.push_back({ &node->_child[1], middle, range._end, range._depth + 1 });
+            }
+            *range._slot = std::move(node);
+        }
+
+        std::sort(subtrees.begin(), subtrees.end(), [](const subtree& a, const subtree& b) {
+            return a._end - a._begin > b._end - b._begin;
+        });
+        _pool->run(static_cast<uint32_t>(subtrees.size()), [&](const uint32_t t) {
+            const auto& range = subtrees[t];
+            *range._slot = build_range(range._begin, range._end, range._depth);
+        });
+
+        _nodes.reserve(2 * _primitive_indices.size());
+        flatten(*root);
+    }
+
+    _bounds    = {};
+    _centroids = {};
+}
+
+// binned SAH split of the primitive range, the cheapest of 'GJK_BVH_BIN_COUNT' - 1 planes 
+// per axis over the centroid bounds. sets the bounds of 'node' and partitions the range, 
+// returns the first primitive of the right child. 'end' when 'node' is a leaf, no split 
+// is cheaper than the leaf. with 'pool' the bounds and the bins are computed in parallel.
+uint32_t gjk::static_bvh::split_range(build_node& node, const uint32_t begin, const uint32_t end, const uint32_t depth, task_pool* pool)
+{
+    const auto count = end - begin;
+
+    const auto bounds = reduce_range<bvh_range_bounds>(pool, begin, end, [&](const uint32_t first, const uint32_t last) {
+        bvh_range_bounds result{};
+        for(auto i = first; i < last; ++i) {
+            const auto p = _primitive_indices[i];
+            merge_into(result, bvh_range_bounds{ _bounds[p], aabb{ _centroids[p], _centroids[p] }, 1 });
+        }
+        return result;
+    });
+    node._box = bounds._box;
+
+    const auto make_leaf = [&]() {
+        node._begin = begin;
+        node._count = count;
+        return end;
+    };
+
+    if(count <= 1 || depth >= GJK_BVH_MAX_DEPTH) {
+        return make_leaf();
+    }
+
+    const auto& centroid_box = bounds._centroid_box;
+    const float centroid_min[3]    = { centroid_box._min.x, centroid_box._min.y, centroid_box._min.z };
+    const float centroid_extent[3] = { 
+        centroid_box._max.x - centroid_box._min.x, 
+        centroid_box._max.y - centroid_box._min.y, 
+        centroid_box._max.z - centroid_box._min.z };
+
+    const auto bin_of = [&](const xfloat3& centroid, const uint32_t axis) {
+        const float c[3] = { centroid.x, centroid.y, centroid.z };
+        const auto b = static_cast<uint32_t>((c[axis] - centroid_min[axis]) / centroid_extent[axis] * GJK_BVH_BIN_COUNT);
+        return std::min(b, GJK_BVH_BIN_COUNT - 1);
+    };
+
+    const auto bins = reduce_range<bvh_bins>(pool, begin, end, [&](const uint32_t first, const uint32_t last) {
+        bvh_bins result{};
+        for(uint32_t axis = 0; axis < 3; ++axis) {
+            if(centroid_extent[axis] <= 0) {
+                continue;
+            }
+            for(auto i = first; i < last; ++i) {
+                const auto p = _primitive_indices[i];
+                auto& b = result._axis[axis][bin_of(_centroids[p], axis)];
+                b._box = b._count ? merge(b._box, _bounds[p]) : _bounds[p];
+                ++b._count;
+            }
+        }
+        return result;
+    });
+
+    auto best_cost  = std::numeric_limits<float>::max();
+    uint32_t best_axis  = 0;
+    uint32_t best_split = 0;
+
+    for(uint32_t axis = 0; axis < 3; ++axis) {
+        if(centroid_extent[axis] <= 0) {
+            continue;
+        }
+        const auto& axis_bins = bins._axis[axis];
+
+        // areas and counts left of every plane, then sweep from the right
+        float    left_area [GJK_BVH_BIN_COUNT]{};
+        uint32_t left_count[GJK_BVH_BIN_COUNT]{};
+        aabb     box{};
+        uint32_t n = 0;
+        for(uint32_t k = 0; k + 1 < GJK_BVH_BIN_COUNT; ++k) {
+            if(axis_bins[k]._count) {
+                box = n ? merge(box, axis_bins[k]._box) : axis_bins[k]._box;
+                n  += axis_bins[k]._count;
+            }
+            left_area[k]  = n ? half_area(box) : 0;
+            left_count[k] = n;
+        }
+
+        n = 0;
+        for(auto k = GJK_BVH_BIN_COUNT - 1; k > 0; --k) {
+            if(axis_bins[k]._count) {
+                box = n ? merge(box, axis_bins[k]._box) : axis_bins[k]._box;
+                n  += axis_bins[k]._count;
+            }
+            if(n == 0 || left_count[k - 1] == 0) {
+                continue;
+            }
+            const auto cost = left_area[k - 1] * left_count[k - 1] + half_area(box) * n;
+            if(cost < best_cost) {
+                best_cost  = cost;
+                best_axis  = axis;
+                best_split = k;
+            }
+        }
+    }
+
+    // traversal and primitive tests weighted the same
+    const auto leaf_cost = half_area(node._box) * count;
+    if(best_cost == std::numeric_limits<float>::max() || (count <= GJK_BVH_MAX_LEAF_SIZE && best_cost >= leaf_cost)) {
+        return make_leaf();
+    }
+
+    return static_cast<uint32_t>(std::partition(
+        _primitive_indices.begin() + begin, 
+        _primitive_indices.begin() + end, 
+        [&](const uint32_t p) { return bin_of(_centroids[p], best_axis) < best_split; }) - _primitive_indices.begin());
+}
+
+// subtree of the primitive range on the calling thread
+std::unique_ptr<gjk::static_bvh::build_node> gjk::static_bvh::build_range(const uint32_t begin, const uint32_t end, const uint32_t depth)
+{
+    auto node = std::make_unique<build_node>();
+    const auto middle = split_range(*node, begin, end, depth, nullptr);
+    if(middle != end) {
+        node->_child[0] = build_range(begin, middle, depth + 1);
+        node->_child[1] = build_range(middle, end, depth + 1);
+    }
+    return node;
+}
+
+// depth-first, the left subtree follows its parent and the right one comes after it
+void gjk::static_bvh::flatten(const build_node& node)
+{
+    const auto index = static_cast<uint32_t>(_nodes.size());
+
+    bvh_node flat{};
+    flat._min[0] = node._box._min.x; flat._min[1] = node._box._min.y; flat._min[2] = node._box._min.z;
+    flat._max[0] = node._box._max.x; flat._max[1] = node._box._max.y; flat._max[2] = node._box._max.z;
+    _nodes.push_back(flat);
+
+    if(!node._child[0]) {
+        _nodes[index]._offset = node._begin;
+        _nodes[index]._count  = node._count;
+        return;
+    }
+
+    flatten(*node._child[0]);
+    _nodes[index]._offset = static_cast<uint32_t>(_nodes.size());
+    flatten(*node._child[1]);
+}
+
+static bool overlaps(const gjk::bvh_node& node, const gjk::aabb& box)
+{
+    return node._min[0] <= box._max.x && box._min.x <= node._max[0] &&
+           node._min[1] <= box._max.y && box._min.y <= node._max[1] &&
+           node._min[2] <= box._max.z && box._min.z <= node._max[2];
+}
+
+void gjk::static_bvh::query(const aabb& bounds_, std::vector<uint32_t>& primitives_) const
+{
+    if(_nodes.empty() || bounds_._min.x > bounds_._max.x) {
+        return;
+    }
+
+    uint32_t stack[GJK_BVH_STACK_SIZE];
+    uint32_t stack_size = 0;
+    stack[stack_size++] = 0;
+
+    while(stack_size > 0) {
+        const auto index = stack[--stack_size];
+        const auto& node = _nodes[index];
+        if(!::overlaps(node, bounds_)) {
+            continue;
+        }
+        if(node._count > 0) {
+            for(auto i = node._offset; i < node._offset + node._count; ++i) {
+                primitives_.push_back(_primitive_indices[i]);
+            }
+            continue;
+        }
+        assert(stack_size + 2 <= GJK_BVH_STACK_SIZE);
+        stack[stack_size++] = node._offset;
+        stack[stack_size++] = index + 1;
+    }
+}
+
+void gjk::static_bvh::find_pairs(std::span<const mesh_object> moving_, std::vector<object_pair>& pairs_) const
+{
+    std::vector<aabb> bounds(moving_.size());
+    for(size_t i = 0; i < moving_.size(); ++i) {
+        bounds[i] = world_bounds(moving_[i]);
+    }
+    find_pairs(bounds, pairs_);
+}
+
+void gjk::static_bvh::find_pairs(std::span<const aabb> moving_, std::vector<object_pair>& pairs_) const
+{
+    std::vector<uint32_t> primitives{};
+    for(uint32_t i = 0; i < moving_.size(); ++i) {
+        primitives.clear();
+        query(moving_[i], primitives);
+        for(const auto p : primitives) {
+            pairs_.push_back(object_pair{ i, p });
+        }
+    }
+}
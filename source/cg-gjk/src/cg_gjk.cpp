@@ -3,13 +3,29 @@
 ///////////////////////////////////////////////////////////////////
 
 #include "cg_gjk.hpp"
+#include "cg_gjk_shapes.hpp"
 #include <vector>
 #include <cassert>
+#include <limits>
+#include <cmath>
+#include <algorithm>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
 
 using namespace s2cpp;
 using namespace mxlib;
 
-struct support_point 
+// simplex vertex, witness tracking keeps the support points of both objects 
+// and their vertex indices, without it only the minkowski position is stored.
+template<bool WITNESS>
+struct basic_support_point;
+
+template<>
+struct basic_support_point<true>
 {
     xfloat3 
     _support_a{};
@@ -19,35 +35,78 @@ struct support_point
 
     xfloat3 
     _position{};
+
+    // vertex indices of the support points, 
+    // used as the starting point of the next search.
+    uint32_t
+    _index_a{};
+
+    uint32_t
+    _index_b{};
+};
+
+template<>
+struct basic_support_point<false>
+{
+    xfloat3 
+    _position{};
 };
 
-static std::vector<xfloat3> transform_mesh_object_vertices_to_ws(const gjk::mesh_object* mesh_object_)
-{   
-    const auto& model_mtx = mesh_object_->_model_mtx;
-    const auto  vertex_count = mesh_object_->_vertex_count;
+using support_point = basic_support_point<true>;
 
-    auto ws_vertices = std::vector<xfloat3>();
-    ws_vertices.resize(vertex_count);
-    for(uint32_t i = 0; i < vertex_count; ++i) {
-        xfloat3 vertex_ = mxlib::transform(mesh_object_->_vertices[i], model_mtx);
-        ws_vertices[i] = vertex_;
-    }
+// support search result of the boolean kernel, the minkowski position and the vertex 
+// indices the next search starts from, the support points of the objects are not kept.
+struct search_point
+{
+    xfloat3 
+    _position{};
+
+    uint32_t
+    _index_a{};
 
-    return ws_vertices;
+    uint32_t
+    _index_b{};
 };
 
-static xfloat3 find_support_point (
+template<bool WITNESS>
+using basic_search_point = std::conditional_t<WITNESS, support_point, search_point>;
+
+template<bool WITNESS, typename Point>
+static basic_support_point<WITNESS> to_simplex_point(const Point& point)
+{
+    if constexpr (WITNESS) {
+        return point;
+    } else {
+        return basic_support_point<false>{ point._position };
+    }
+}
+
+// rotates a world space direction into the local space of the object.
+//
+// support function of a linearly transformed point set satisfies
+// max(d · Mv) = max((Mᵀd) · v), so instead of transforming every vertex to world space
+// we multiply the search direction by the transpose of the upper 3x3 of the model matrix,
+// translation does not affect which vertex is the furthest one.
+static xfloat3 direction_to_ls(const xfloat3& direction, const xfloat4x4& model_mtx)
+{
+    return xfloat3(
+        model_mtx[0] * direction.x + model_mtx[4] * direction.y + model_mtx[8]  * direction.z,
+        model_mtx[1] * direction.x + model_mtx[5] * direction.y + model_mtx[9]  * direction.z,
+        model_mtx[2] * direction.x + model_mtx[6] * direction.y + model_mtx[10] * direction.z);
+}
+
+static uint32_t find_support_point (
     const xfloat3& search_direction, 
     const xfloat3* verts,
     const uint32_t count) 
 {
     if(count == 0) {
-        return {0,0,0};
+        return 0;
     }
     // finding a vertex with the biggest magnitude in the specified direction,
     // this is easily tested by calculating the dot product of direction argument and vertex.
-    auto best_index = 0;
-    auto best_match = dot_product(search_direction, verts[0]);
+    uint32_t best_index = 0;
+    auto     best_match = dot_product(search_direction, verts[0]);
     for(uint32_t i = 1; i < count; ++i){
         const auto dot = dot_product(search_direction, verts[i]);
         if(dot > best_match) {
@@ -55,210 +114,507 @@ static xfloat3 find_support_point (
             best_match   = dot;
         }
     }
-    return verts[best_index];
+    return best_index;
 }
 
-static support_point find_minkowski_support (
-    const xfloat3& search_direction, 
-    const xfloat3* verts_a, 
-    const xfloat3* verts_b,
-    const uint32_t count_a,
-    const uint32_t count_b) 
+// vectorized version of 'find_support_point' over the structure-of-arrays vertex streams,
+// each lane keeps its own best dot product and index, lanes are reduced at the end.
+// ties are resolved to the lowest index, same as the scalar version does.
+static uint32_t find_support_point_soa (
+    const xfloat3&           search_direction,
+    const gjk::soa_vertices* soa_)
 {
-    support_point point = {};
+    const auto padded_count = static_cast<uint32_t>(soa_->_x.size());
+    const auto xs = soa_->_x.data();
+    const auto ys = soa_->_y.data();
+    const auto zs = soa_->_z.data();
 
-    // find and store support points of the objects
-    point._support_a = find_support_point(negate(search_direction), verts_a, count_a);
-    point._support_b = find_support_point(search_direction, verts_b, count_b);
+    if(padded_count == 0) {
+        return 0;
+    }
 
-    // calculate minkowski sum (or "difference" in our case) by subtracting A and B support points,
-    point._position = point._support_b - point._support_a;
+#if defined(__AVX2__)
+    constexpr uint32_t width = 8;
 
-    return point;
+    const __m256  dx = _mm256_set1_ps(search_direction.x);
+    const __m256  dy = _mm256_set1_ps(search_direction.y);
+    const __m256  dz = _mm256_set1_ps(search_direction.z);
+    const __m256i step = _mm256_set1_epi32(width);
+
+    __m256i lane_index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i best_index = lane_index;
+    __m256  best_match = _mm256_set1_ps(-std::numeric_limits<float>::infinity());
+
+    for(uint32_t i = 0; i < padded_count; i += width) {
+        const __m256 dot = _mm256_add_ps(
+            _mm256_add_ps(
+                _mm256_mul_ps(dx, _mm256_loadu_ps(xs + i)),
+                _mm256_mul_ps(dy, _mm256_loadu_ps(ys + i))),
+                _mm256_mul_ps(dz, _mm256_loadu_ps(zs + i)));
+
+        const __m256 greater = _mm256_cmp_ps(dot, best_match, _CMP_GT_OQ);
+        best_match = _mm256_blendv_ps(best_match, dot, greater);
+        best_index = _mm256_castps_si256(_mm256_blendv_ps(
+            _mm256_castsi256_ps(best_index), 
+            _mm256_castsi256_ps(lane_index), greater));
+        lane_index = _mm256_add_epi32(lane_index, step);
+    }
+
+    alignas(32) float    lane_match[width];
+    alignas(32) uint32_t lane_best [width];
+    _mm256_store_ps(lane_match, best_match);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lane_best), best_index);
+#elif defined(__SSE4_1__)
+    constexpr uint32_t width = 4;
+
+    const __m128  dx = _mm_set1_ps(search_direction.x);
+    const __m128  dy = _mm_set1_ps(search_direction.y);
+    const __m128  dz = _mm_set1_ps(search_direction.z);
+    const __m128i step = _mm_set1_epi32(width);
+
+    __m128i lane_index = _mm_setr_epi32(0, 1, 2, 3);
+    __m128i best_index = lane_index;
+    __m128  best_match = _mm_set1_ps(-std::numeric_limits<float>::infinity());
+
+    for(uint32_t i = 0; i < padded_count; i += width) {
+        const __m128 dot = _mm_add_ps(
+            _mm_add_ps(
+                _mm_mul_ps(dx, _mm_loadu_ps(xs + i)),
+                _mm_mul_ps(dy, _mm_loadu_ps(ys + i))),
+                _mm_mul_ps(dz, _mm_loadu_ps(zs + i)));
+
+        const __m128 greater = _mm_cmpgt_ps(dot, best_match);
+        best_match = _mm_blendv_ps(best_match, dot, greater);
+        best_index = _mm_castps_si128(_mm_blendv_ps(
+            _mm_castsi128_ps(best_index), 
+            _mm_castsi128_ps(lane_index), greater));
+        lane_index = _mm_add_epi32(lane_index, step);
+    }
+
+    alignas(16) float    lane_match[width];
+    alignas(16) uint32_t lane_best [width];
+    _mm_store_ps(lane_match, best_match);
+    _mm_store_si128(reinterpret_cast<__m128i*>(lane_best), best_index);
+#else
+    // scalar fallback, still benefits from the SoA layout as the
+    // compiler is free to auto-vectorize the lane loop.
+    constexpr uint32_t width = 4;
+
+    float    lane_match[width];
+    uint32_t lane_best [width];
+    for(uint32_t k = 0; k < width; ++k) {
+        lane_match[k] = -std::numeric_limits<float>::infinity();
+        lane_best [k] = k;
+    }
+
+    for(uint32_t i = 0; i < padded_count; i += width) {
+        for(uint32_t k = 0; k < width; ++k) {
+            const auto dot = 
+                search_direction.x * xs[i + k] + 
+                search_direction.y * ys[i + k] + 
+                search_direction.z * zs[i + k];
+            if(dot > lane_match[k]) {
+                lane_match[k] = dot;
+                lane_best [k] = i + k;
+            }
+        }
+    }
+#endif
+
+    // reduce lanes
+    uint32_t best_index_ = lane_best[0];
+    float    best_match_ = lane_match[0];
+    for(uint32_t k = 1; k < width; ++k) {
+        if(lane_match[k] > best_match_ || (lane_match[k] == best_match_ && lane_best[k] < best_index_)) {
+            best_match_ = lane_match[k];
+            best_index_ = lane_best[k];
+        }
+    }
+
+    // padding repeats the first vertex
+    return best_index_ < soa_->_vertex_count ? best_index_ : 0;
 }
 
-static bool test_simplex(fixed_list<support_point, 4>& simplex, xfloat3& direction)
-{    
-    // case 1D - line
-    if(simplex.size() == 2)
+static bool is_primitive(const gjk::mesh_object* object_)
+{
+    return object_->_primitive._type != gjk::GJK_PRIMITIVE_NONE;
+}
+
+// closed-form support point of the primitive in its local space
+static xfloat3 find_primitive_support_point(const xfloat3& search_direction, const gjk::primitive_shape& primitive_)
+{
+    const auto& d = search_direction;
+    const auto sign = [](float v) { return v < 0 ? -1.0f : 1.0f; };
+    const auto length = std::sqrt(dot_product(d, d));
+    
+    // direction scaled to the radius, any point on the sphere will do for zero direction
+    const auto on_sphere = [&](float radius) {
+        return length > 0 ? d * (radius / length) : xfloat3(radius, 0, 0);
+    };
+
+    // same on the xz-plane disc
+    const auto on_disc = [&](float radius, float y) {
+        const auto sigma = std::sqrt(d.x * d.x + d.z * d.z);
+        return sigma > 0 ? xfloat3(d.x * radius / sigma, y, d.z * radius / sigma) : xfloat3(0, y, 0);
+    };
+
+    switch(primitive_._type)
     {
-        // direction of the line, from 0 to 1
-        xfloat3 d01 = simplex[1]._position - simplex[0]._position;
-
-        // direction towards origin, as vertex position (or translation from the origin) is 
-        // always pointing away from the origin, we can simply negate it to get 
-        // the reversed direction towards the origin.
-        xfloat3 dto = negate(simplex[0]._position);
-
-        // is the line pointing towards the origin?
-        if(dot_product(d01, dto) > 0) {
-
-            // perpendicular explained:
-            // two geometric objects are perpendicular
-            // when they intersect exactly at an angle of 90 degrees (or π/2 radians),
-            // Good characteristic to remember is that dot product of a perpendicular 
-            // lines is always zero.
-            //
-            //           line1
-            //             |   
-            //    line0 ___|___
-            //
-            // looking at the crude visualization above, we can say 
-            // line0 and line1 are perpendicular.
-
-            // we calculate perpendicular of the line (towards the origin) to use 
-            // as the next search direction to find suitable support point
-            // to form a triangle 
-            xfloat3 perp_01 = triple_product(d01, dto, d01);
-            direction = perp_01;
-        } else {
-            // line was not pointing towards the origin, so we will use the negated position(A) 
-            // of the simplex as the next search direction, we can be certain its pointing
-            // towards the origin
-            direction = dto;
+        case gjk::GJK_PRIMITIVE_SPHERE: {
+            return on_sphere(primitive_._radius);
         }
-        return false;
+        case gjk::GJK_PRIMITIVE_CAPSULE: {
+            return xfloat3(0, sign(d.y) * primitive_._half_height, 0) + on_sphere(primitive_._radius);
+        }
+        case gjk::GJK_PRIMITIVE_BOX: {
+            const auto& e = primitive_._half_extents;
+            return xfloat3(sign(d.x) * e.x, sign(d.y) * e.y, sign(d.z) * e.z);
+        }
+        case gjk::GJK_PRIMITIVE_CYLINDER: {
+            return on_disc(primitive_._radius, sign(d.y) * primitive_._half_height);
+        }
+        case gjk::GJK_PRIMITIVE_CONE: {
+            // apex wins when the direction is within the cone's half angle from +y
+            const auto radius = primitive_._radius;
+            const auto height = 2.0f * primitive_._half_height;
+            const auto sin_angle = radius / std::sqrt(radius * radius + height * height);
+            if(d.y > length * sin_angle) {
+                return xfloat3(0, primitive_._half_height, 0);
+            }
+            return on_disc(radius, -primitive_._half_height);
+        }
+        case gjk::GJK_PRIMITIVE_ELLIPSOID: {
+            // support of the unit sphere scaled by the radii, direction is scaled by the radii too
+            const auto& e = primitive_._half_extents;
+            const auto scaled = xfloat3(d.x * e.x * e.x, d.y * e.y * e.y, d.z * e.z * e.z);
+            const auto norm = std::sqrt(d.x * scaled.x + d.y * scaled.y + d.z * scaled.z);
+            return norm > 0 ? scaled * (1.0f / norm) : xfloat3(e.x, 0, 0);
+        }
+        default: break;
     }
+    return xfloat3(0, 0, 0);
+}
 
-    // case 2D - triangle
-    if(simplex.size() == 3)
+// vertices used by the support search, cooked hull when available
+static const xfloat3* object_vertices(const gjk::mesh_object* object_)
+{
+    return object_->_convex_shape ? object_->_convex_shape->vertices() : object_->_vertices;
+}
+
+static uint32_t object_vertex_count(const gjk::mesh_object* object_)
+{
+    return object_->_convex_shape ? object_->_convex_shape->vertex_count() : object_->_vertex_count;
+}
+
+// walks the hull from the 'start' vertex towards the support direction, moving to the best
+// neighbour as long as it improves. on a convex hull a vertex with no better neighbour
+// is the global maximum, and as the answer moves very little between GJK iterations
+// the walk is only a few steps long when started from the previous support vertex.
+static uint32_t find_support_point_hill_climb (
+    const xfloat3&           search_direction,
+    const gjk::convex_shape* shape_,
+    const uint32_t           start)
+{
+    const auto vertices  = shape_->vertices();
+    const auto offsets   = shape_->adjacency_offsets();
+    const auto adjacency = shape_->adjacency();
+
+    uint32_t current    = start < shape_->vertex_count() ? start : 0;
+    auto     best_match = dot_product(search_direction, vertices[current]);
+
+    while(1)
     {
-        // 1 _____ 0
-        //   \   /
-        //    \ /              
-        //     2
+        uint32_t next = current;
+        for(uint32_t k = offsets[current]; k < offsets[current + 1]; ++k) {
+            const auto neighbour = adjacency[k];
+            const auto dot = dot_product(search_direction, vertices[neighbour]);
+            if(dot > best_match) {
+                best_match = dot;
+                next = neighbour;
+            }
+        }
 
-        // triangle forming lines 2 => 0 and 2 => 1,
-        
-        // we call these lines "right" and "left"  
-        // to make this part easier to conceptualize. 
+        if(next == current) {
+            return current;
+        }
+        current = next;
+    }
+}
+
+// finds the support point of the object in world space direction,
+// only the winning vertex is transformed to world space.
+static xfloat3 find_object_support_point (
+    const xfloat3&           search_direction,
+    const gjk::mesh_object*  object_,
+    uint32_t&                index)
+{
+    const auto local_direction = direction_to_ls(search_direction, object_->_model_mtx);
+
+    if(is_primitive(object_)) {
+        index = 0;
+        return mxlib::transform(find_primitive_support_point(local_direction, object_->_primitive), object_->_model_mtx);
+    }
     
-        // "right" line
-        xfloat3 d20 = simplex[0]._position - simplex[2]._position;
-        // "left" line
-        xfloat3 d21 = simplex[1]._position - simplex[2]._position;
-
-        // direction towards the origin
-        xfloat3 dto = negate(simplex[2]._position);
-
-        // we calculate a perpendicular (or normal) of the triangle surface by calculating
-        // the cross product of the triangle forming lines.   
-        xfloat3 perp = cross_product(d21, d20); 
-            
-        // is the origin on the "right" side of the triangle?
-        if(mixed_product(perp, d20, dto) > 0) {
-            // is the "right" line facing the origin? 
-            if(dot_product(d20, dto) > 0) {
-                // set the next search direction towards the origin.
-                direction = triple_product(d20, dto, d20);
-                // remove the point that is not part of the "right" line.
-                simplex.remove(1);
-                return false; 
+    if(const auto shape_ = object_->_convex_shape) {
+        if(shape_->has_adjacency() && shape_->vertex_count() >= gjk::GJK_HILL_CLIMB_MIN_VERTICES) {
+            // 'index' holds the previous support vertex, if the lookup table 
+            // has a better starting point, we will start from there instead.
+            // both come from outside the search and are checked before use.
+            const auto vertex_count = shape_->vertex_count();
+            if(index >= vertex_count) {
+                index = 0;
             }
-        } 
-        // is the origin on the right side of the "left" line? 
-        else if(mixed_product(d21, perp, dto) <= 0) {
-            if(dot_product(perp, dto) > 0) {
-                // the origin is above 
-                direction = perp;
-            } else {   
-                // the origin is below,
-                //
-                // swap points 0 and 1 to maintain
-                // the correct order of the triangle,
-                // or in other words, to maintain 
-                // the correct side of the 
-                // surface normal.
-                simplex.swap(0, 1);
-                direction = negate(perp);
+            if(shape_->has_direction_lut()) {
+                const auto vertices  = shape_->vertices();
+                const auto lut_index = shape_->direction_lut()[gjk::direction_lut_cell(local_direction)];
+                if(lut_index < vertex_count && dot_product(local_direction, vertices[lut_index]) > dot_product(local_direction, vertices[index])) {
+                    index = lut_index;
+                }
             }
-            return false;
+            index = find_support_point_hill_climb(local_direction, shape_, index);
+        } else {
+            index = find_support_point_soa(local_direction, &shape_->soa());
         }
+    } else if(object_->_soa_vertices) {
+        index = find_support_point_soa(local_direction, object_->_soa_vertices);
+    } else {
+        index = find_support_point(local_direction, object_->_vertices, object_->_vertex_count);
+    }
+
+    return mxlib::transform(object_vertices(object_)[index], object_->_model_mtx);
+}
+
+// 'Point' is 'support_point', or 'search_point' when the support points of the objects 
+// are not needed.
+template<typename Point = support_point>
+static Point find_minkowski_support (
+    const xfloat3&          search_direction, 
+    const gjk::mesh_object* object_a, 
+    const gjk::mesh_object* object_b,
+    const Point*            previous = nullptr) 
+{
+    Point point = {};
+
+    // start from the previous support vertices
+    if(previous) {
+        point._index_a = previous->_index_a;
+        point._index_b = previous->_index_b;
+    }
+
+    // find support points of the objects
+    const auto support_a = find_object_support_point(negate(search_direction), object_a, point._index_a);
+    const auto support_b = find_object_support_point(search_direction, object_b, point._index_b);
+    if constexpr (std::is_same_v<Point, support_point>) {
+        point._support_a = support_a;
+        point._support_b = support_b;
+    }
+
+    // calculate minkowski sum (or "difference" in our case) by subtracting A and B support points,
+    point._position = support_b - support_a;
 
-        // is the "left" line facing the origin?
-        if(dot_product(d21, dto) > 0){
-            // set the next search direction towards the origin.
-            direction  = triple_product(d21, dto, d21);
-            // remove the point that is not part of the "left" line.
-            simplex.remove(0);
-        } 
-        else {
-            // if we got here, we can't refine the simplex
-            // in any meaningful way based on the current 
-            // set of points, we will just reset the simplex,
-            // set the next search direction to DTO
-            // and start over.
-            direction = dto;
-            simplex.reset();
+    return point;
+}
+
+// shared with the compile-time shape path
+using gjk::detail::test_simplex;
+
+xfloat3 gjk::support(const mesh_object& object_, const xfloat3& direction)
+{
+    uint32_t index = 0;
+    const auto point = find_object_support_point(direction, &object_, index);
+    if(object_._margin > 0) {
+        // core support point pushed out by the margin
+        const auto length = std::sqrt(dot_product(direction, direction));
+        return length > 0 ? point + direction * (object_._margin / length) : point;
+    }
+    return point;
+}
+
+void gjk::build_soa_vertices(const xfloat3* vertices_, const uint32_t vertex_count_, soa_vertices* soa_)
+{
+    assert(soa_ && "'soa_' can't be null");
+
+    *soa_ = {};
+    if(!vertices_ || vertex_count_ == 0) {
+        return;
+    }
+
+    const uint32_t padded_count = 
+        (vertex_count_ + GJK_SOA_PADDING - 1) / GJK_SOA_PADDING * GJK_SOA_PADDING;
+
+    soa_->_x.resize(padded_count);
+    soa_->_y.resize(padded_count);
+    soa_->_z.resize(padded_count);
+    soa_->_vertex_count = vertex_count_;
+
+    for(uint32_t i = 0; i < padded_count; ++i) {
+        // padding repeats the first vertex, it can't 
+        // beat the original one as ties resolve to the lowest index.
+        const auto& vertex_ = vertices_[i < vertex_count_ ? i : 0];
+        soa_->_x[i] = vertex_.x;
+        soa_->_y[i] = vertex_.y;
+        soa_->_z[i] = vertex_.z;
+    }
+}
+
+// support point built from known vertex indices, used to re-evaluate a cached simplex
+// with the current transforms of the objects.
+static support_point find_minkowski_support_from_indices (
+    const gjk::mesh_object* object_a,
+    const gjk::mesh_object* object_b,
+    const uint32_t          index_a,
+    const uint32_t          index_b)
+{
+    support_point point = {};
+    point._index_a   = index_a;
+    point._index_b   = index_b;
+    point._support_a = mxlib::transform(object_vertices(object_a)[index_a], object_a->_model_mtx);
+    point._support_b = mxlib::transform(object_vertices(object_b)[index_b], object_b->_model_mtx);
+    point._position  = point._support_b - point._support_a;
+    return point;
+}
+
+// a cached simplex has no guaranteed winding, so unlike 'test_simplex' all four
+// faces are tested, origin must be on the same side as the opposite vertex for each face.
+//
+// 'tolerance_' lets the origin be outside of a face by that distance.
+static bool tetrahedron_contains_origin(const fixed_list<support_point, 4>& simplex, const float tolerance_ = 0)
+{
+    constexpr uint32_t faces[4][4] = {{0, 1, 2, 3}, {0, 1, 3, 2}, {0, 2, 3, 1}, {1, 2, 3, 0}};
+    for(const auto& face : faces) {
+        const auto& p0 = simplex[face[0]]._position;
+        const auto perp = cross_product(simplex[face[1]]._position - p0, simplex[face[2]]._position - p0);
+        const auto side_vertex = dot_product(perp, simplex[face[3]]._position - p0);
+        const auto side_origin = dot_product(perp, negate(p0));
+        if(side_vertex == 0) {
+            return false;
+        }
+        if(side_vertex * side_origin < 0 && side_origin * side_origin > tolerance_ * tolerance_ * dot_product(perp, perp)) {
+            return false;
         }
+    }
+    return true;
+}
 
-        return false;
+static void store_simplex_cache(gjk::simplex_cache_entry* entry_, const fixed_list<support_point, 4>& simplex, const xfloat3& direction)
+{
+    if(!entry_) {
+        return;
+    }
+    entry_->_count = static_cast<uint8_t>(simplex.size());
+    for(uint32_t i = 0; i < simplex.size(); ++i) {
+        entry_->_indices_a[i] = simplex[i]._index_a;
+        entry_->_indices_b[i] = simplex[i]._index_b;
     }
+    entry_->_direction = direction;
+}
 
-    // case 3D - tetrahedron
-    if(simplex.size() == 4)
-    {
-        //       3
-        //      /|\
-        //     / | \
-        //    /  |  \
-        //   1'-.|.-'0
-        //       2
-
-        // tetrahedron forming lines 3 => 2, 3 => 1, 3 => 0
-        xfloat3 d32 = simplex[2]._position - simplex[3]._position;
-        xfloat3 d31 = simplex[1]._position - simplex[3]._position;
-        xfloat3 d30 = simplex[0]._position - simplex[3]._position;
-        
-        // direction towards the origin
-        xfloat3 dto = negate(simplex[3]._position);
-
-        // perpendicular vector for the each newly formed triangle surface,
-        // notice the clockwise order.
-        xfloat3 perp321 = cross_product(d32, d31);
-        xfloat3 perp310 = cross_product(d31, d30);
-        xfloat3 perp302 = cross_product(d30, d32);
-
-        // there are only three tests left  
-        // to determine if the formed tetrahedron contains  
-        // the origin.  
-        //  
-        // for each newly formed triangular surface and  
-        // the direction towards the origin, we calculate  
-        // the plane distance to determine whether the  
-        // origin is contained within the surface's  
-        // hyperplane.  
-        //  
-        // if the origin is not contained within the triangle's plane,  
-        // we know it lies in front of the triangle.  
-        // In this case, we remove the only support point  
-        // that is not part of the triangle from the simplex,  
-        // set the next search direction to normal  
-        // of the triangle surface, and then exit to form a new tetrahedron.  
-        //  
-        // if the origin is contained within all the triangle planes,  
-        // we return 'true' from this function, indicating that  
-        // the origin is enclosed within the simplex.
-        if(dot_product(perp321, dto) > 0) {
-            direction = perp321;
-            simplex.remove(0);
-        }
-        else if(dot_product(perp310, dto) > 0) {
-            direction = perp310;
-            simplex.remove(2);
-        }
-        else if(dot_product(perp302, dto) > 0) {
-            direction = perp302;
-            simplex.remove(1);
-        }
-        else {
-            // We have encapsulated the origin! 
-            // intersection between objects is happening.
-            return true;
-        }
-    }
-
-    return false;
+// closest point of the simplex to the origin as barycentric combination of the simplex points,
+// only the points with non-zero weight (the closest sub-simplex) are kept.
+using gjk::detail::simplex_closest_point;
+
+static simplex_closest_point closest_point_on_segment(const xfloat3& a, const xfloat3& b, uint32_t ia, uint32_t ib)
+{
+    simplex_closest_point result{};
+
+    const auto ab = b - a;
+    const auto length_sq = dot_product(ab, ab);
+    const auto t = length_sq > 0 ? dot_product(negate(a), ab) / length_sq : 0.0f;
+
+    if(t <= 0) {
+        result._point = a; result._count = 1;
+        result._indices[0] = ia; result._weights[0] = 1;
+    } else if(t >= 1) {
+        result._point = b; result._count = 1;
+        result._indices[0] = ib; result._weights[0] = 1;
+    } else {
+        result._point = a + ab * t; result._count = 2;
+        result._indices[0] = ia; result._weights[0] = 1 - t;
+        result._indices[1] = ib; result._weights[1] = t;
+    }
+    return result;
+}
+
+// voronoi region tests of the triangle, see Ericson, Real-Time Collision Detection 5.1.5
+static simplex_closest_point closest_point_on_triangle(const xfloat3& a, const xfloat3& b, const xfloat3& c, uint32_t ia, uint32_t ib, uint32_t ic)
+{
+    const auto ab = b - a;
+    const auto ac = c - a;
+
+    // vertex region a
+    const auto ap = negate(a);
+    const auto d1 = dot_product(ab, ap);
+    const auto d2 = dot_product(ac, ap);
+    if(d1 <= 0 && d2 <= 0) {
+        return closest_point_on_segment(a, a, ia, ia);
+    }
+
+    // vertex region b
+    const auto bp = negate(b);
+    const auto d3 = dot_product(ab, bp);
+    const auto d4 = dot_product(ac, bp);
+    if(d3 >= 0 && d4 <= d3) {
+        return closest_point_on_segment(b, b, ib, ib);
+    }
+
+    // edge region ab
+    const auto vc = d1 * d4 - d3 * d2;
+    if(vc <= 0 && d1 >= 0 && d3 <= 0) {
+        return closest_point_on_segment(a, b, ia, ib);
+    }
+
+    // vertex region c
+    const auto cp = negate(c);
+    const auto d5 = dot_product(ab, cp);
+    const auto d6 = dot_product(ac, cp);
+    if(d6 >= 0 && d5 <= d6) {
+        return closest_point_on_segment(c, c, ic, ic);
+    }
+
+    // edge region ac
+    const auto vb = d5 * d2 - d1 * d6;
+    if(vb <= 0 && d2 >= 0 && d6 <= 0) {
+        return closest_point_on_segment(a, c, ia, ic);
+    }
+
+    // edge region bc
+    const auto va = d3 * d6 - d5 * d4;
+    if(va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0) {
+        return closest_point_on_segment(b, c, ib, ic);
+    }
+
+    const auto denom = va + vb + vc;
+    if(denom <= 0) {
+        // degenerate (zero area) triangle, closest of the edges will do
+        auto best = closest_point_on_segment(a, b, ia, ib);
+        for(const auto& edge : {closest_point_on_segment(a, c, ia, ic), closest_point_on_segment(b, c, ib, ic)}) {
+            if(dot_product(edge._point, edge._point) < dot_product(best._point, best._point)) {
+                best = edge;
+            }
+        }
+        return best;
+    }
+
+    // face region
+    simplex_closest_point result{};
+    const auto v = vb / denom;
+    const auto w = vc / denom;
+    result._point = a + ab * v + ac * w;
+    result._count = 3;
+    result._indices[0] = ia; result._weights[0] = 1 - v - w;
+    result._indices[1] = ib; result._weights[1] = v;
+    result._indices[2] = ic; result._weights[2] = w;
+    return result;
+}
+
+// signed volumes, same subalgorithm as the simplex test
+static simplex_closest_point closest_point_on_simplex(const fixed_list<support_point, 4>& simplex)
+{
+    xfloat3 points[4];
+    for(uint32_t i = 0; i < simplex.size(); ++i) {
+        points[i] = simplex[i]._position;
+    }
+    return gjk::detail::signed_volumes(points, simplex.size());
 }
 
 template<auto MASK>
@@ -266,8 +622,28 @@ inline constexpr auto mask_if_false(const bool cond) {
     return !cond * MASK;
 }
 
-gjk::result_bits gjk::intersects(const mesh_object* alpha_, const mesh_object* beta_, uint32_t max_iter_, by_products_data* by_products)
+// raw vertex arrays of two objects are the same
+static bool shares_raw_vertices(const gjk::mesh_object* alpha_, const gjk::mesh_object* beta_)
 {
+    const auto raw_a = !is_primitive(alpha_) && !alpha_->_convex_shape;
+    const auto raw_b = !is_primitive(beta_)  && !beta_->_convex_shape;
+    return raw_a && raw_b && alpha_->_vertices == beta_->_vertices;
+}
+
+static std::underlying_type<gjk::result_bits>::type validate_object_vertices(const gjk::mesh_object* object_)
+{
+    if(is_primitive(object_)) {
+        return gjk::GJK_EMPTY_MASK;
+    }
+    return 
+        mask_if_false<gjk::GJK_ERROR_NULL_VERTEX_ARRAY_BIT>(object_vertices(object_) != nullptr) |
+        mask_if_false<gjk::GJK_ERROR_NOT_ENOUGH_VERTICES_BIT>(object_vertex_count(object_) >= 3);
+}
+
+static gjk::result_bits validate_objects(const gjk::mesh_object* alpha_, const gjk::mesh_object* beta_)
+{
+    using namespace gjk;
+
     // argument validation checks
     std::underlying_type<gjk::result_bits>::type validation_error_bits = 
         mask_if_false<GJK_ERROR_SAME_OBJECT_BIT>(alpha_ != beta_) |
@@ -275,25 +651,56 @@ gjk::result_bits gjk::intersects(const mesh_object* alpha_, const mesh_object* b
 
     if(validation_error_bits == GJK_EMPTY_MASK) {
         // alpha_ and beta_ pointers can be dereferenced, add rest of the checks
+        // cooked shapes are meant to be shared between objects, 
+        // same vertex array check applies only to raw vertices.
+        // primitives have no vertices to check.
         validation_error_bits |= 
-        mask_if_false<GJK_ERROR_SAME_VERTEX_ARRAY_BIT>(alpha_->_vertices != beta_->_vertices)  |
-        mask_if_false<GJK_ERROR_NULL_VERTEX_ARRAY_BIT>(alpha_->_vertices && beta_ ->_vertices) |
-        mask_if_false<GJK_ERROR_NOT_ENOUGH_VERTICES_BIT>(alpha_->_vertex_count >= 3 && beta_->_vertex_count >= 3);
+        mask_if_false<GJK_ERROR_SAME_VERTEX_ARRAY_BIT>(!shares_raw_vertices(alpha_, beta_)) |
+        validate_object_vertices(alpha_) |
+        validate_object_vertices(beta_);
     }
 
     if(validation_error_bits  != GJK_EMPTY_MASK) {
         // add the invalid bit '0000 0001' as validation was not successful
         validation_error_bits |= GJK_INVALID_BIT;
-        return static_cast<gjk::result_bits>(validation_error_bits);
     }
 
-    if(by_products) { *by_products = {}; }
+    return static_cast<gjk::result_bits>(validation_error_bits);
+}
+
+// boolean GJK, objects must be validated. 'simplex' is the terminating simplex, 
+// when intersecting it's the tetrahedron enclosing the origin (or less if 'max_iter_' was reached).
+// the kernel is configured by 'Policy' (see 'gjk::gjk_policy'), tracing and witness 
+// bookkeeping are compiled in only when enabled, disabled ones leave no branches in the loop.
+template<typename Policy>
+static gjk::result_bits run_gjk (
+    const gjk::mesh_object*       alpha_, 
+    const gjk::mesh_object*       beta_, 
+    const uint32_t                max_iter_, 
+    gjk::by_products_data*        by_products, 
+    gjk::simplex_cache_entry*     warm_start,
+    fixed_list<basic_support_point<Policy::track_witness>, 4>& simplex)
+{
+    using namespace gjk;
 
-    // transform vertices to common space (world space)
-    auto wverts_a = transform_mesh_object_vertices_to_ws(alpha_);
-    auto wverts_b = transform_mesh_object_vertices_to_ws(beta_);
+    static_assert(std::is_same_v<typename Policy::scalar, float>, "mesh objects are single precision, use 'REBASE' far from the origin");
 
-    fixed_list<support_point, 4> simplex{};
+    constexpr auto WITNESS = Policy::track_witness;
+
+    if constexpr (Policy::trace) { by_products->reset(); }
+
+    // warm start needs the vertex indices of the simplex
+    const auto store_cache = [&](const xfloat3& direction) {
+        if constexpr (WITNESS) {
+            store_simplex_cache(warm_start, simplex, direction);
+        }
+    };
+
+    // support points are searched in the local space of each object and only the
+    // winning vertices are transformed to common space (world space), no need to
+    // transform (or allocate) the whole vertex arrays up front.
+
+    simplex.reset();
 
     auto wpos_a = xfloat3(alpha_->_model_mtx[3], alpha_->_model_mtx[7], alpha_->_model_mtx[11]);
     auto wpos_b = xfloat3(beta_->_model_mtx[3], beta_->_model_mtx[7], beta_->_model_mtx[11]);
@@ -301,25 +708,78 @@ gjk::result_bits gjk::intersects(const mesh_object* alpha_, const mesh_object* b
     // we can use any direction to find a initial support point for simplex construction
     auto search_direction = wpos_b - wpos_a;
 
+    // the most recent support point, its vertices are the starting point of the next search
+    basic_search_point<WITNESS> last_support_point{};
+
+    // warm start from the previous query of the same pair, cached indices
+    // are re-evaluated with the current transforms.
+    if constexpr (WITNESS) {
+        if(warm_start && warm_start->_count > 0 && warm_start->_count <= 4) 
+        {
+            const auto count_a = object_vertex_count(alpha_);
+            const auto count_b = object_vertex_count(beta_);
+
+            // support points of primitives are not vertices, only the direction can be reused
+            const auto indexed = !is_primitive(alpha_) && !is_primitive(beta_);
+
+            fixed_list<support_point, 4> cached{};
+            for(uint32_t i = 0; indexed && i < warm_start->_count; ++i) {
+                if(warm_start->_indices_a[i] >= count_a || warm_start->_indices_b[i] >= count_b) {
+                    // shape has changed, cache is stale
+                    cached.reset();
+                    break;
+                }
+                cached.add(find_minkowski_support_from_indices(
+                    alpha_, beta_, warm_start->_indices_a[i], warm_start->_indices_b[i]));
+            }
+
+            if(cached.size() == 4 && tetrahedron_contains_origin(cached)) {
+                // still intersecting, no iterations needed
+                simplex.reset();
+                for(uint32_t i = 0; i < cached.size(); ++i) {
+                    simplex.add(to_simplex_point<WITNESS>(cached[i]));
+                }
+                if constexpr (Policy::trace) {
+                    for(uint32_t i = 0; i < cached.size(); ++i){
+                        by_products->_simplex_points.add(cached[i]._position);
+                    }
+                }
+                return GJK_INTERSECTING_BIT;
+            }
+
+            if(cached.size() > 0) {
+                last_support_point = cached[cached.size() - 1];
+            }
+
+            if(warm_start->_count < 4 && dot_product(warm_start->_direction, warm_start->_direction) > 0) {
+                // pair was separated, most likely the same direction still separates them
+                search_direction = warm_start->_direction;
+            }
+        }
+    }
+
     // add starting point to simplex
     const auto initial_support_point = 
-        find_minkowski_support(
-            search_direction,
-            wverts_a.data(), 
-            wverts_b.data(), 
-            (uint32_t)wverts_a.size(), 
-            (uint32_t)wverts_b.size());
+        find_minkowski_support(search_direction, alpha_, beta_, &last_support_point);
+    last_support_point = initial_support_point;
     
-    simplex.add(initial_support_point);
+    simplex.add(to_simplex_point<WITNESS>(initial_support_point));
     
     // store the current state of the simplex to buffer, 
     // this to visualize the construction steps.
-    if(by_products) {
+    if constexpr (Policy::trace) {
         fixed_list<xfloat3, 4> store_simplex{};
         for(uint32_t i = 0; i < simplex.size(); ++i){
             store_simplex.add(simplex[i]._position);   
         }
-        by_products->_simplex_construction_buffer.push_back(store_simplex);
+        by_products->_simplex_construction_buffer.push(store_simplex);
+    }
+
+    // minkowski difference is entirely behind the plane through the origin,
+    // the search direction is a separating axis, early exit.
+    if(dot_product(initial_support_point._position, search_direction) < 0) {
+        store_cache(search_direction);
+        return GJK_EMPTY_MASK;
     }
 
     // we use the initial support point to calculate our next search direction, next search direction must 
@@ -327,34 +787,43 @@ gjk::result_bits gjk::intersects(const mesh_object* alpha_, const mesh_object* b
     search_direction = negate(initial_support_point._position); 
 
     uint32_t iter = 0;
+    bool converged = true;
     while(1) 
     {
         // find next support point
         auto support_point = 
-            find_minkowski_support(
-                search_direction,
-                wverts_a.data(), 
-                wverts_b.data(), 
-                (uint32_t)wverts_a.size(), 
-                (uint32_t)wverts_b.size());
+            find_minkowski_support(search_direction, alpha_, beta_, &last_support_point);
+        last_support_point = support_point;
 
         // we are beyond the origin, early exit
         if(dot_product(support_point._position, search_direction) < 0) {
             // no collision, we will return GJK_EMPTY value
+            simplex.add(to_simplex_point<WITNESS>(support_point));
+            store_cache(search_direction);
             return GJK_EMPTY_MASK;
         }
+
+        // same support point again, the simplex can't get any closer to the origin. the search 
+        // direction did not separate the objects, so the origin is on the boundary within 
+        // float noise, touching is reported as intersecting.
+        if constexpr (Policy::termination == GJK_TERMINATION_RELATIVE) {
+            if(gjk::detail::is_duplicate(simplex, support_point._position)) {
+                converged = false;
+                break;
+            }
+        }
         
         // add support point to simplex
-        simplex.add(support_point);
+        simplex.add(to_simplex_point<WITNESS>(support_point));
         
         // store the current state of the simplex to buffer, 
         // this to visualize the construction steps.
-        if(by_products) {
+        if constexpr (Policy::trace) {
             fixed_list<xfloat3, 4> store_simplex{};
             for(uint32_t i = 0; i < simplex.size(); ++i){
                 store_simplex.add(simplex[i]._position);   
             }
-            by_products->_simplex_construction_buffer.push_back(store_simplex);
+            by_products->_simplex_construction_buffer.push(store_simplex);
         }
 
         if(test_simplex(simplex, search_direction)) 
@@ -371,18 +840,996 @@ gjk::result_bits gjk::intersects(const mesh_object* alpha_, const mesh_object* b
             // other or intersecting, purpose of this implementation is not to provide 
             // solution for highly accurate physics simulation (32 bit floating point scalar type makes this extremely challening already), 
             // instead we aim for high-perfomance reasonable accurate approximation for general purposes, we can assume 
-            // intersection is happening.  
+            // intersection is happening, 'GJK_NOT_CONVERGED_BIT' lets the caller know it's a guess.
+            converged = false;
             break;
         }
     }
 
-    if(by_products) {
+    if constexpr (Policy::trace) {
         for(uint32_t i = 0; i < simplex.size(); ++i){
             by_products->_simplex_points.add(simplex[i]._position);
         }
     }
 
+    store_cache(search_direction);
+
     // intersection is happening, we will return GJK_INTERSECTING_BIT
+    if(!converged) {
+        return static_cast<result_bits>(GJK_INTERSECTING_BIT | GJK_NOT_CONVERGED_BIT);
+    }
     return GJK_INTERSECTING_BIT;
 }
 
+// outcome of the GJK distance iteration
+typedef enum distance_state : uint8_t {
+    GJK_DISTANCE_SEPARATED    = 0,
+    GJK_DISTANCE_INTERSECTING = 1,
+    // distance is proven to be larger than the cutoff, 'closest' is not converged
+    GJK_DISTANCE_BEYOND_CUTOFF = 2,
+    // distance is proven to be at most the cutoff, 'closest' is not converged
+    GJK_DISTANCE_WITHIN_CUTOFF = 3,
+
+} distance_state;
+
+// classic GJK distance iteration, 'closest' is the point of the current simplex closest 
+// to the origin, the next support point is searched towards the origin from it
+// and the simplex is reduced to the sub-simplex supporting the closest point.
+//
+// 'closest' is an upper bound of the distance and each support point gives a lower bound. 
+// a lower bound beyond 'cutoff_' always ends the iteration (infinite cutoff disables it),
+// 'stop_within_cutoff_' also stops on an upper bound within the cutoff, when only the 
+// comparison matters and not the converged distance.
+static distance_state run_gjk_distance (
+    const gjk::mesh_object*       alpha_, 
+    const gjk::mesh_object*       beta_, 
+    const uint32_t                max_iter_,
+    const float                   tolerance_,
+    const float                   cutoff_,
+    const bool                    stop_within_cutoff_,
+    fixed_list<support_point, 4>& simplex,
+    simplex_closest_point&        closest,
+    bool&                         converged)
+{
+    auto wpos_a = xfloat3(alpha_->_model_mtx[3], alpha_->_model_mtx[7], alpha_->_model_mtx[11]);
+    auto wpos_b = xfloat3(beta_->_model_mtx[3], beta_->_model_mtx[7], beta_->_model_mtx[11]);
+
+    simplex.reset();
+    simplex.add(find_minkowski_support(wpos_a - wpos_b, alpha_, beta_));
+
+    closest = closest_point_on_simplex(simplex);
+
+    const auto cutoff_sq = cutoff_ * cutoff_;
+    converged = true;
+
+    uint32_t iter = 0;
+    for(; iter < max_iter_; ++iter)
+    {
+        const auto closest_sq = dot_product(closest._point, closest._point);
+
+        // origin is (numerically) on the simplex
+        xfloat3 points[4];
+        for(uint32_t i = 0; i < simplex.size(); ++i) {
+            points[i] = simplex[i]._position;
+        }
+        if(gjk::detail::on_simplex(closest._point, points, simplex.size())) {
+            return GJK_DISTANCE_INTERSECTING;
+        }
+
+        if(stop_within_cutoff_ && closest_sq <= cutoff_sq) {
+            return GJK_DISTANCE_WITHIN_CUTOFF;
+        }
+
+        const auto next_support = find_minkowski_support(negate(closest._point), alpha_, beta_, &simplex[simplex.size() - 1]);
+
+        // support plane separates the origin by more than the cutoff
+        const auto lower_bound = dot_product(closest._point, next_support._position);
+        if(lower_bound > 0 && lower_bound * lower_bound > cutoff_sq * closest_sq) {
+            return GJK_DISTANCE_BEYOND_CUTOFF;
+        }
+
+        // no progress towards the origin, 'closest' is the closest point of the minkowski difference
+        if(closest_sq - lower_bound <= tolerance_ * closest_sq) {
+            break;
+        }
+
+        // same support point twice, can't improve anymore
+        if(gjk::detail::is_duplicate(simplex, next_support._position)) {
+            break;
+        }
+
+        simplex.add(next_support);
+        
+        const auto next = closest_point_on_simplex(simplex);
+        if(next._count == 4) {
+            // tetrahedron encloses the origin
+            return GJK_DISTANCE_INTERSECTING;
+        }
+
+        // keep only the supporting sub-simplex
+        fixed_list<support_point, 4> reduced{};
+        for(uint32_t i = 0; i < next._count; ++i) {
+            reduced.add(simplex[next._indices[i]]);
+        }
+        simplex = reduced;
+        closest = next;
+        closest._count = next._count;
+        for(uint32_t i = 0; i < next._count; ++i) {
+            closest._indices[i] = i;
+        }
+    }
+
+    converged = iter < max_iter_;
+
+    if(stop_within_cutoff_) {
+        return dot_product(closest._point, closest._point) <= cutoff_sq ? GJK_DISTANCE_WITHIN_CUTOFF : GJK_DISTANCE_BEYOND_CUTOFF;
+    }
+
+    return GJK_DISTANCE_SEPARATED;
+}
+
+// witness points of the core shapes from the barycentric weights of the closest sub-simplex
+static void closest_core_points(const fixed_list<support_point, 4>& simplex, const simplex_closest_point& closest, xfloat3& point_a, xfloat3& point_b)
+{
+    point_a = xfloat3(0, 0, 0);
+    point_b = xfloat3(0, 0, 0);
+    for(uint32_t i = 0; i < closest._count; ++i) {
+        point_a = point_a + simplex[closest._indices[i]]._support_a * closest._weights[i];
+        point_b = point_b + simplex[closest._indices[i]]._support_b * closest._weights[i];
+    }
+}
+
+static float object_margin_sum(const gjk::mesh_object* alpha_, const gjk::mesh_object* beta_)
+{
+    return alpha_->_margin + beta_->_margin;
+}
+
+// boolean test of objects with margins, distance between the cores is compared against the 
+// margins, near-touching pairs are decided by the distance bounds instead of spinning
+// the simplex on float noise.
+static gjk::result_bits run_gjk_margin(const gjk::mesh_object* alpha_, const gjk::mesh_object* beta_, const uint32_t max_iter_)
+{
+    fixed_list<support_point, 4> simplex{};
+    simplex_closest_point closest{};
+    bool converged = true;
+    const auto state = run_gjk_distance(
+        alpha_, beta_, max_iter_, 1e-6f, object_margin_sum(alpha_, beta_), true, simplex, closest, converged);
+    
+    std::underlying_type<gjk::result_bits>::type bits = 
+        state == GJK_DISTANCE_BEYOND_CUTOFF ? gjk::GJK_EMPTY_MASK : gjk::GJK_INTERSECTING_BIT;
+    return static_cast<gjk::result_bits>(bits | mask_if_false<gjk::GJK_NOT_CONVERGED_BIT>(converged));
+}
+
+gjk::result_bits gjk::intersects(const mesh_object* alpha_, const mesh_object* beta_, uint32_t max_iter_, by_products_data* by_products, simplex_cache_entry* warm_start)
+{
+    // tracing is picked once per query, the untraced kernel has no tracing branches
+    if(by_products) {
+        return intersects<trace_policy>(alpha_, beta_, max_iter_, by_products, warm_start);
+    }
+    return intersects<default_policy>(alpha_, beta_, max_iter_, nullptr, warm_start);
+}
+
+// local bounds of a primitive, all of them are centered at the local origin
+static xfloat3 primitive_half_extents(const gjk::primitive_shape& primitive_)
+{
+    const auto r = primitive_._radius;
+    const auto h = primitive_._half_height;
+    switch(primitive_._type)
+    {
+        case gjk::GJK_PRIMITIVE_SPHERE:    return xfloat3(r, r, r);
+        case gjk::GJK_PRIMITIVE_CAPSULE:   return xfloat3(r, h + r, r);
+        case gjk::GJK_PRIMITIVE_BOX:       return primitive_._half_extents;
+        case gjk::GJK_PRIMITIVE_CYLINDER:  return xfloat3(r, h, r);
+        case gjk::GJK_PRIMITIVE_CONE:      return xfloat3(r, h, r);
+        case gjk::GJK_PRIMITIVE_ELLIPSOID: return primitive_._half_extents;
+        default: break;
+    }
+    return xfloat3(0, 0, 0);
+}
+
+static bool same_matrix(const xfloat4x4& a, const xfloat4x4& b)
+{
+    for(uint32_t i = 0; i < 16; ++i) {
+        if(a[i] != b[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// world bounds of the object for its current model matrix, false for raw vertices
+static bool compute_bounds(const gjk::mesh_object& object_, gjk::bounds_cache& bounds_)
+{
+    using namespace gjk;
+
+    // local box as center and half extents, sphere radius
+    xfloat3 local_center{0, 0, 0};
+    xfloat3 half_extents{};
+    float   radius{};
+    if(is_primitive(&object_)) {
+        half_extents = primitive_half_extents(object_._primitive);
+        // the sphere of a sphere is exact, the corner of the box bounds the rest
+        radius = object_._primitive._type == GJK_PRIMITIVE_SPHERE ? 
+            object_._primitive._radius : std::sqrt(dot_product(half_extents, half_extents));
+    } else if(const auto shape_ = object_._convex_shape) {
+        const auto& box = shape_->local_bounds();
+        local_center = shape_->sphere_center();
+        half_extents = (box._max - box._min) * 0.5f;
+        radius       = shape_->sphere_radius();
+    } else {
+        return false;
+    }
+
+    // box of the transformed box, |M| applied to the half extents. the radius grows 
+    // with the largest column scale.
+    const auto& m = object_._model_mtx;
+    const auto center = mxlib::transform(local_center, m);
+    const auto extents = xfloat3(
+        std::abs(m[0]) * half_extents.x + std::abs(m[1]) * half_extents.y + std::abs(m[2])  * half_extents.z,
+        std::abs(m[4]) * half_extents.x + std::abs(m[5]) * half_extents.y + std::abs(m[6])  * half_extents.z,
+        std::abs(m[8]) * half_extents.x + std::abs(m[9]) * half_extents.y + std::abs(m[10]) * half_extents.z);
+
+    auto scale_sq = 0.0f;
+    for(uint32_t column = 0; column < 3; ++column) {
+        scale_sq = std::max(scale_sq, m[column] * m[column] + m[4 + column] * m[4 + column] + m[8 + column] * m[8 + column]);
+    }
+
+    const auto margin = xfloat3(object_._margin, object_._margin, object_._margin);
+    bounds_._model_mtx     = m;
+    bounds_._box           = aabb{ center - extents - margin, center + extents + margin };
+    bounds_._sphere_center = center;
+    bounds_._sphere_radius = radius * std::sqrt(scale_sq) + object_._margin;
+    bounds_._valid         = true;
+    return true;
+}
+
+void gjk::update_bounds(mesh_object& object_)
+{
+    const auto& cache = object_._bounds_cache;
+    if(cache._valid && same_matrix(cache._model_mtx, object_._model_mtx)) {
+        return;
+    }
+    object_._bounds_cache = {};
+    compute_bounds(object_, object_._bounds_cache);
+}
+
+const gjk::bounds_cache* gjk::object_bounds(const mesh_object& object_, bounds_cache& scratch_)
+{
+    const auto& cache = object_._bounds_cache;
+    if(cache._valid && same_matrix(cache._model_mtx, object_._model_mtx)) {
+        return &cache;
+    }
+    return compute_bounds(object_, scratch_) ? &scratch_ : nullptr;
+}
+
+// object bounds prove the pair is apart, sphere test first then the boxes. 
+// pairs with raw vertex objects are never rejected.
+static bool bounds_separated(const gjk::mesh_object* alpha_, const gjk::mesh_object* beta_)
+{
+    gjk::bounds_cache scratch_a{};
+    gjk::bounds_cache scratch_b{};
+    const auto bounds_a = gjk::object_bounds(*alpha_, scratch_a);
+    const auto bounds_b = gjk::object_bounds(*beta_, scratch_b);
+    if(!bounds_a || !bounds_b) {
+        return false;
+    }
+
+    const auto d = bounds_b->_sphere_center - bounds_a->_sphere_center;
+    const auto r = bounds_a->_sphere_radius + bounds_b->_sphere_radius;
+    return dot_product(d, d) > r * r || !gjk::overlaps(bounds_a->_box, bounds_b->_box);
+}
+
+// copies of the pair translated so the midpoint of their origins is at the world origin, 
+// the midpoint and the new translations are computed in double. only the model matrices 
+// are copied, vertex data is shared.
+static void rebase_pair(const gjk::mesh_object* alpha_, const gjk::mesh_object* beta_, gjk::mesh_object (&rebased)[2])
+{
+    rebased[0] = *alpha_;
+    rebased[1] = *beta_;
+    for(const uint32_t i : {3u, 7u, 11u}) {
+        const auto midpoint = (static_cast<double>(alpha_->_model_mtx[i]) + static_cast<double>(beta_->_model_mtx[i])) * 0.5;
+        rebased[0]._model_mtx[i] = static_cast<float>(alpha_->_model_mtx[i] - midpoint);
+        rebased[1]._model_mtx[i] = static_cast<float>(beta_->_model_mtx[i] - midpoint);
+    }
+}
+
+template<typename Policy>
+gjk::result_bits gjk::intersects(const mesh_object* alpha_, const mesh_object* beta_, uint32_t max_iter_, by_products_data* by_products, simplex_cache_entry* warm_start)
+{
+    if(const auto validation_error_bits = validate_objects(alpha_, beta_); validation_error_bits != GJK_EMPTY_MASK) {
+        return validation_error_bits;
+    }
+
+    assert((!Policy::trace || by_products) && "tracing policy requires 'by_products'");
+
+    // far apart, no vertex data is touched
+    if(bounds_separated(alpha_, beta_)) {
+        if(by_products) { by_products->reset(); }
+        return GJK_EMPTY_MASK;
+    }
+
+    gjk::mesh_object rebased[2];
+    if constexpr (Policy::rebase_origin) {
+        rebase_pair(alpha_, beta_, rebased);
+        alpha_ = &rebased[0];
+        beta_  = &rebased[1];
+    }
+
+    if(object_margin_sum(alpha_, beta_) > 0) {
+        // warm start and by-products are for the simplex test only
+        if(by_products) { by_products->reset(); }
+        return run_gjk_margin(alpha_, beta_, max_iter_);
+    }
+
+    fixed_list<basic_support_point<Policy::track_witness>, 4> simplex{};
+    return run_gjk<Policy>(alpha_, beta_, max_iter_, by_products, warm_start, simplex);
+}
+
+template gjk::result_bits gjk::intersects<gjk::default_policy>(const mesh_object*, const mesh_object*, uint32_t, by_products_data*, simplex_cache_entry*);
+template gjk::result_bits gjk::intersects<gjk::trace_policy>(const mesh_object*, const mesh_object*, uint32_t, by_products_data*, simplex_cache_entry*);
+template gjk::result_bits gjk::intersects<gjk::boolean_policy>(const mesh_object*, const mesh_object*, uint32_t, by_products_data*, simplex_cache_entry*);
+template gjk::result_bits gjk::intersects<gjk::boolean_capped_policy>(const mesh_object*, const mesh_object*, uint32_t, by_products_data*, simplex_cache_entry*);
+template gjk::result_bits gjk::intersects<gjk::rebased_policy>(const mesh_object*, const mesh_object*, uint32_t, by_products_data*, simplex_cache_entry*);
+
+gjk::result_bits gjk::distance(const mesh_object* alpha_, const mesh_object* beta_, distance_result* result_, uint32_t max_iter_, float tolerance_)
+{
+    if(const auto validation_error_bits = validate_objects(alpha_, beta_); validation_error_bits != GJK_EMPTY_MASK) {
+        return validation_error_bits;
+    }
+
+    assert(result_ && "'result_' can't be null");
+    *result_ = {};
+
+    fixed_list<support_point, 4> simplex{};
+    simplex_closest_point closest{};
+    bool converged = true;
+    const auto state = run_gjk_distance(
+        alpha_, beta_, max_iter_, tolerance_, std::numeric_limits<float>::infinity(), false, simplex, closest, converged);
+
+    const auto not_converged_bit = mask_if_false<GJK_NOT_CONVERGED_BIT>(converged);
+    if(state == GJK_DISTANCE_INTERSECTING) {
+        return GJK_INTERSECTING_BIT;
+    }
+
+    // margins are added analytically, the cores are separated by the core distance
+    const auto core_distance = std::sqrt(dot_product(closest._point, closest._point));
+    const auto distance_ = core_distance - object_margin_sum(alpha_, beta_);
+    if(distance_ <= 0) {
+        return static_cast<result_bits>(GJK_INTERSECTING_BIT | not_converged_bit);
+    }
+
+    xfloat3 point_a, point_b;
+    closest_core_points(simplex, closest, point_a, point_b);
+
+    const auto axis = closest._point * (1.0f / core_distance);
+    result_->_distance        = distance_;
+    result_->_point_a         = point_a + axis * alpha_->_margin;
+    result_->_point_b         = point_b - axis * beta_->_margin;
+    result_->_separating_axis = axis;
+
+    return static_cast<result_bits>(not_converged_bit);
+}
+
+// adds a triangle to the polytope, winding must be counter-clockwise seen from outside.
+static void epa_add_face(gjk::epa_scratch& scratch, uint32_t a, uint32_t b, uint32_t c)
+{
+    const auto& pa = scratch._vertices[a]._position;
+    const auto& pb = scratch._vertices[b]._position;
+    const auto& pc = scratch._vertices[c]._position;
+
+    gjk::epa_face face{};
+    face._v[0] = a;
+    face._v[1] = b;
+    face._v[2] = c;
+
+    const auto perp = cross_product(pb - pa, pc - pa);
+    const auto length = std::sqrt(dot_product(perp, perp));
+    if(length > 0) {
+        face._normal   = perp * (1.0f / length);
+        face._distance = dot_product(face._normal, pa);
+    } else {
+        // degenerate face, never the closest one
+        face._normal   = xfloat3(0, 0, 0);
+        face._distance = std::numeric_limits<float>::max();
+    }
+
+    scratch._faces.push_back(face);
+}
+
+// edge shared by two removed faces is not on the horizon, 
+// as the winding is consistent the neighbour has it reversed.
+static void epa_add_horizon_edge(gjk::epa_scratch& scratch, uint32_t a, uint32_t b)
+{
+    for(size_t i = 0; i < scratch._edges.size(); ++i) {
+        if(scratch._edges[i]._a == b && scratch._edges[i]._b == a) {
+            scratch._edges[i] = scratch._edges.back();
+            scratch._edges.pop_back();
+            return;
+        }
+    }
+    scratch._edges.push_back({a, b});
+}
+
+// GJK may terminate with less than four points (or a flat tetrahedron) when the origin 
+// is touching the simplex, we add support points in the missing dimensions to get a volume.
+static bool epa_blow_up_simplex(const gjk::mesh_object* alpha_, const gjk::mesh_object* beta_, fixed_list<support_point, 4>& simplex)
+{
+    constexpr auto epsilon = 1e-6f;
+
+    const auto try_add = [&](const xfloat3& direction, auto&& accept) {
+        for(const auto& d : {direction, negate(direction)}) {
+            const auto point = find_minkowski_support(d, alpha_, beta_, &simplex[simplex.size() - 1]);
+            if(accept(point._position)) {
+                simplex.add(point);
+                return true;
+            }
+        }
+        return false;
+    };
+
+    if(simplex.size() == 0) {
+        return false;
+    }
+
+    if(simplex.size() == 1) {
+        const auto p0 = simplex[0]._position;
+        const auto accept = [&](const xfloat3& p) { const auto d = p - p0; return dot_product(d, d) > epsilon; };
+        try_add(xfloat3(1, 0, 0), accept) || try_add(xfloat3(0, 1, 0), accept) || try_add(xfloat3(0, 0, 1), accept);
+    }
+
+    if(simplex.size() == 2) {
+        const auto p0 = simplex[0]._position;
+        const auto line = simplex[1]._position - p0;
+        const auto accept = [&](const xfloat3& p) { const auto c = cross_product(line, p - p0); return dot_product(c, c) > epsilon; };
+
+        // perpendiculars of the line, crossed with the least aligned axis
+        const auto ax = line.x < 0 ? -line.x : line.x;
+        const auto ay = line.y < 0 ? -line.y : line.y;
+        const auto az = line.z < 0 ? -line.z : line.z;
+        const auto axis = (ax <= ay && ax <= az) ? xfloat3(1, 0, 0) : (ay <= az ? xfloat3(0, 1, 0) : xfloat3(0, 0, 1));
+        const auto perp0 = cross_product(line, axis);
+        const auto perp1 = cross_product(line, perp0);
+        try_add(perp0, accept) || try_add(perp1, accept);
+    }
+
+    if(simplex.size() == 3) {
+        const auto p0 = simplex[0]._position;
+        const auto perp = cross_product(simplex[1]._position - p0, simplex[2]._position - p0);
+        const auto accept = [&](const xfloat3& p) { const auto d = dot_product(perp, p - p0); return d * d > epsilon * dot_product(perp, perp); };
+        try_add(perp, accept);
+    }
+
+    if(simplex.size() != 4) {
+        return false;
+    }
+
+    // GJK stops when the origin is on the simplex within the relative tolerance, 
+    // it can be just outside of the tetrahedron built around it.
+    auto size_sq = 0.0f;
+    for(uint32_t i = 0; i < 4; ++i) {
+        size_sq = std::max(size_sq, dot_product(simplex[i]._position, simplex[i]._position));
+    }
+    return tetrahedron_contains_origin(simplex, gjk::GJK_RELATIVE_EPSILON * std::sqrt(size_sq));
+}
+
+// contact of objects with margins, shallow contacts (cores separated by less than the margins) 
+// are answered from the core distance alone, returns 'false' when the cores intersect and 
+// the penetration of the cores is needed.
+static bool margin_contact(const gjk::mesh_object* alpha_, const gjk::mesh_object* beta_, gjk::contact_result* result_, const uint32_t max_iter_, gjk::result_bits& bits)
+{
+    const auto margins = object_margin_sum(alpha_, beta_);
+
+    // cores further apart than the margins leave early with 'GJK_DISTANCE_BEYOND_CUTOFF', 
+    // closer ones need the converged distance for the depth, no stop within the cutoff.
+    fixed_list<support_point, 4> simplex{};
+    simplex_closest_point closest{};
+    bool converged = true;
+    const auto state = run_gjk_distance(
+        alpha_, beta_, max_iter_, 1e-6f, margins, false, simplex, closest, converged);
+
+    if(state == GJK_DISTANCE_INTERSECTING) {
+        return false;
+    }
+
+    const auto not_converged_bit = mask_if_false<gjk::GJK_NOT_CONVERGED_BIT>(converged);
+    bits = static_cast<gjk::result_bits>(not_converged_bit);
+    if(state == GJK_DISTANCE_BEYOND_CUTOFF) {
+        return true;
+    }
+
+    const auto core_distance = std::sqrt(dot_product(closest._point, closest._point));
+    if(core_distance >= margins) {
+        return true;
+    }
+
+    xfloat3 point_a, point_b;
+    closest_core_points(simplex, closest, point_a, point_b);
+
+    // closest point of the minkowski difference points from alpha towards beta
+    result_->_normal  = closest._point * (1.0f / core_distance);
+    result_->_depth   = margins - core_distance;
+    result_->_point_a = point_a + result_->_normal * alpha_->_margin;
+    result_->_point_b = point_b - result_->_normal * beta_->_margin;
+
+    bits = static_cast<gjk::result_bits>(gjk::GJK_INTERSECTING_BIT | not_converged_bit);
+    return true;
+}
+
+// contact of the cores to contact of the inflated objects, margins push the 
+// surfaces out along the normal and add up to the depth.
+static void inflate_contact(const gjk::mesh_object* alpha_, const gjk::mesh_object* beta_, gjk::contact_result* result_)
+{
+    result_->_depth   = result_->_depth + object_margin_sum(alpha_, beta_);
+    result_->_point_a = result_->_point_a + result_->_normal * alpha_->_margin;
+    result_->_point_b = result_->_point_b - result_->_normal * beta_->_margin;
+}
+
+static gjk::result_bits epa_penetration(const gjk::mesh_object* alpha_, const gjk::mesh_object* beta_, gjk::contact_result* result_, gjk::epa_scratch* scratch_, uint32_t max_iter_, float tolerance_)
+{
+    using namespace gjk;
+
+    fixed_list<support_point, 4> simplex{};
+    if(!contains(run_gjk<gjk::default_policy>(alpha_, beta_, max_iter_, nullptr, nullptr, simplex), GJK_INTERSECTING_BIT)) {
+        return GJK_EMPTY_MASK;
+    }
+
+    if(!epa_blow_up_simplex(alpha_, beta_, simplex)) {
+        // objects are only touching (or the simplex is too flat to expand), 
+        // report zero depth along the direction between the objects.
+        const auto wpos_a = xfloat3(alpha_->_model_mtx[3], alpha_->_model_mtx[7], alpha_->_model_mtx[11]);
+        const auto wpos_b = xfloat3(beta_->_model_mtx[3], beta_->_model_mtx[7], beta_->_model_mtx[11]);
+        const auto axis = wpos_b - wpos_a;
+        const auto length = std::sqrt(dot_product(axis, axis));
+        result_->_normal  = length > 0 ? axis * (1.0f / length) : xfloat3(0, 1, 0);
+        result_->_point_a = simplex.size() > 0 ? simplex[0]._support_a : wpos_a;
+        result_->_point_b = simplex.size() > 0 ? simplex[0]._support_b : wpos_b;
+        return GJK_INTERSECTING_BIT;
+    }
+
+    epa_scratch local_scratch{};
+    auto& scratch = scratch_ ? *scratch_ : local_scratch;
+    scratch._vertices.clear();
+    scratch._faces.clear();
+    scratch._edges.clear();
+
+    for(uint32_t i = 0; i < 4; ++i) {
+        scratch._vertices.push_back({
+            simplex[i]._position, simplex[i]._support_a, simplex[i]._support_b, 
+            simplex[i]._index_a,  simplex[i]._index_b});
+    }
+
+    // initial tetrahedron faces, each oriented away from the opposite vertex
+    constexpr uint32_t faces[4][4] = {{0, 1, 2, 3}, {0, 1, 3, 2}, {0, 2, 3, 1}, {1, 2, 3, 0}};
+    for(const auto& face : faces) {
+        const auto& p0 = simplex[face[0]]._position;
+        const auto perp = cross_product(simplex[face[1]]._position - p0, simplex[face[2]]._position - p0);
+        if(dot_product(perp, simplex[face[3]]._position - p0) > 0) {
+            epa_add_face(scratch, face[0], face[2], face[1]);
+        } else {
+            epa_add_face(scratch, face[0], face[1], face[2]);
+        }
+    }
+
+    uint32_t closest = 0;
+    bool converged = false;
+    for(uint32_t iter = 0; iter < max_iter_; ++iter)
+    {
+        // face of the polytope closest to the origin
+        closest = 0;
+        for(uint32_t i = 1; i < scratch._faces.size(); ++i) {
+            if(scratch._faces[i]._distance < scratch._faces[closest]._distance) {
+                closest = i;
+            }
+        }
+
+        const auto face = scratch._faces[closest];
+        const auto& last_vertex = scratch._vertices[face._v[0]];
+
+        support_point hint{};
+        hint._index_a = last_vertex._index_a;
+        hint._index_b = last_vertex._index_b;
+        const auto point = find_minkowski_support(face._normal, alpha_, beta_, &hint);
+
+        // polytope can't be expanded any further in the direction of the closest face, 
+        // the face is on the boundary of the minkowski difference.
+        if(dot_product(point._position, face._normal) - face._distance <= tolerance_) {
+            converged = true;
+            break;
+        }
+
+        const auto new_index = static_cast<uint32_t>(scratch._vertices.size());
+        scratch._vertices.push_back({
+            point._position, point._support_a, point._support_b, 
+            point._index_a,  point._index_b});
+
+        // remove the faces the new point can see, their outline (horizon) 
+        // is connected to the new point.
+        scratch._edges.clear();
+        for(size_t i = 0; i < scratch._faces.size();) {
+            const auto& f = scratch._faces[i];
+            if(dot_product(f._normal, point._position - scratch._vertices[f._v[0]]._position) > 0) {
+                epa_add_horizon_edge(scratch, f._v[0], f._v[1]);
+                epa_add_horizon_edge(scratch, f._v[1], f._v[2]);
+                epa_add_horizon_edge(scratch, f._v[2], f._v[0]);
+                scratch._faces[i] = scratch._faces.back();
+                scratch._faces.pop_back();
+            } else {
+                ++i;
+            }
+        }
+
+        if(scratch._edges.empty()) {
+            // numerically nothing to expand, keep the current closest face
+            scratch._faces.push_back(face);
+            closest = static_cast<uint32_t>(scratch._faces.size() - 1);
+            break;
+        }
+
+        for(const auto& edge : scratch._edges) {
+            epa_add_face(scratch, edge._a, edge._b, new_index);
+        }
+
+        closest = 0;
+        for(uint32_t i = 1; i < scratch._faces.size(); ++i) {
+            if(scratch._faces[i]._distance < scratch._faces[closest]._distance) {
+                closest = i;
+            }
+        }
+    }
+
+    // witness points from the barycentric coordinates of the origin 
+    // projected on the closest face.
+    const auto& face = scratch._faces[closest];
+    const auto& v0 = scratch._vertices[face._v[0]];
+    const auto& v1 = scratch._vertices[face._v[1]];
+    const auto& v2 = scratch._vertices[face._v[2]];
+    const auto projection = closest_point_on_triangle(v0._position, v1._position, v2._position, 0, 1, 2);
+
+    const gjk::epa_vertex* vertices[3] = {&v0, &v1, &v2};
+    xfloat3 point_a{0, 0, 0};
+    xfloat3 point_b{0, 0, 0};
+    for(uint32_t i = 0; i < projection._count; ++i) {
+        point_a = point_a + vertices[projection._indices[i]]->_support_a * projection._weights[i];
+        point_b = point_b + vertices[projection._indices[i]]->_support_b * projection._weights[i];
+    }
+
+    // minkowski difference is beta - alpha, its boundary normal points away from 
+    // the origin, beta must be moved against it to separate the objects.
+    result_->_depth   = face._distance;
+    result_->_normal  = negate(face._normal);
+    result_->_point_a = point_a;
+    result_->_point_b = point_b;
+
+    if(!converged) {
+        // 'max_iter_' reached or the polytope could not be expanded, depth is an upper bound
+        return static_cast<result_bits>(GJK_INTERSECTING_BIT | GJK_NOT_CONVERGED_BIT);
+    }
+    return GJK_INTERSECTING_BIT;
+}
+
+gjk::result_bits gjk::penetration(const mesh_object* alpha_, const mesh_object* beta_, contact_result* result_, epa_scratch* scratch_, uint32_t max_iter_, float tolerance_)
+{
+    if(const auto validation_error_bits = validate_objects(alpha_, beta_); validation_error_bits != GJK_EMPTY_MASK) {
+        return validation_error_bits;
+    }
+
+    assert(result_ && "'result_' can't be null");
+    *result_ = {};
+
+    if(object_margin_sum(alpha_, beta_) > 0) {
+        if(gjk::result_bits bits{}; margin_contact(alpha_, beta_, result_, max_iter_, bits)) {
+            return bits;
+        }
+    }
+
+    const auto bits = epa_penetration(alpha_, beta_, result_, scratch_, max_iter_, tolerance_);
+    if(contains(bits, GJK_INTERSECTING_BIT)) {
+        inflate_contact(alpha_, beta_, result_);
+    }
+    return bits;
+}
+
+// a point inside the object in world space, primitives are centered at the origin, for 
+// cooked shapes the precomputed center, raw vertices are averaged as the object origin may be outside of the mesh.
+static xfloat3 object_interior_point(const gjk::mesh_object* object_)
+{
+    if(is_primitive(object_)) {
+        return mxlib::transform(xfloat3(0, 0, 0), object_->_model_mtx);
+    }
+
+    if(object_->_convex_shape) {
+        return mxlib::transform(object_->_convex_shape->center(), object_->_model_mtx);
+    }
+
+    xfloat3 center{0, 0, 0};
+    for(uint32_t i = 0; i < object_->_vertex_count; ++i) {
+        center = center + object_->_vertices[i];
+    }
+    return mxlib::transform(center * (1.0f / static_cast<float>(object_->_vertex_count)), object_->_model_mtx);
+}
+
+static gjk::result_bits run_mpr(const gjk::mesh_object* alpha_, const gjk::mesh_object* beta_, gjk::contact_result* result_, uint32_t max_iter_, float tolerance_)
+{
+    using namespace gjk;
+
+    const auto is_zero = [](const xfloat3& v) { 
+        return dot_product(v, v) <= std::numeric_limits<float>::epsilon() * std::numeric_limits<float>::epsilon(); 
+    };
+
+    const auto normalized = [](const xfloat3& v) { 
+        return v * (1.0f / std::sqrt(dot_product(v, v))); 
+    };
+
+    // 'a' x 'b' is float noise relative to the lengths, an absolute epsilon misses it for 
+    // smooth shapes (spheres), where the support point is exactly on the ray from 'v0'.
+    const auto is_parallel = [](const xfloat3& a, const xfloat3& b) {
+        const auto c = cross_product(a, b);
+        constexpr auto epsilon = gjk::GJK_RELATIVE_EPSILON;
+        return dot_product(c, c) <= epsilon * epsilon * dot_product(a, a) * dot_product(b, b);
+    };
+
+    // portal vertices are points of the minkowski difference (beta - alpha),
+    // 'v0' is an interior point, the ray from it towards the origin is what we are refining
+    // the portal (v1, v2, v3) around.
+    support_point v0{};
+    v0._support_a = object_interior_point(alpha_);
+    v0._support_b = object_interior_point(beta_);
+    v0._position  = v0._support_b - v0._support_a;
+
+    if(is_zero(v0._position)) {
+        // interior points overlap, any direction will do
+        v0._position = xfloat3(1e-5f, 0, 0);
+    }
+
+    // phase 1, portal discovery
+
+    auto direction = negate(v0._position);
+    auto v1 = find_minkowski_support(direction, alpha_, beta_);
+    if(dot_product(v1._position, direction) <= 0) {
+        return GJK_EMPTY_MASK;
+    }
+
+    direction = cross_product(v1._position, v0._position);
+    if(is_parallel(v1._position, v0._position)) {
+        // origin is on the segment v0 => v1, v1 is on the boundary
+        const auto normal = normalized(v1._position - v0._position);
+        result_->_depth   = dot_product(v1._position, normal);
+        result_->_normal  = negate(normal);
+        result_->_point_a = v1._support_a;
+        result_->_point_b = v1._support_b;
+        return GJK_INTERSECTING_BIT;
+    }
+
+    auto v2 = find_minkowski_support(direction, alpha_, beta_, &v1);
+    if(dot_product(v2._position, direction) <= 0) {
+        return GJK_EMPTY_MASK;
+    }
+
+    direction = cross_product(v1._position - v0._position, v2._position - v0._position);
+    if(dot_product(direction, v0._position) > 0) {
+        std::swap(v1, v2);
+        direction = negate(direction);
+    }
+
+    support_point v3{};
+    bool portal_found = false;
+    uint32_t iter = 0;
+    for(; iter < max_iter_; ++iter)
+    {
+        v3 = find_minkowski_support(direction, alpha_, beta_, &v2);
+        if(dot_product(v3._position, direction) <= 0) {
+            return GJK_EMPTY_MASK;
+        }
+
+        // origin outside of the plane (v0, v1, v3), replace v2
+        if(dot_product(cross_product(v1._position, v3._position), v0._position) < 0) {
+            v2 = v3;
+            direction = cross_product(v1._position - v0._position, v3._position - v0._position);
+            continue;
+        }
+
+        // origin outside of the plane (v0, v3, v2), replace v1
+        if(dot_product(cross_product(v3._position, v2._position), v0._position) < 0) {
+            v1 = v3;
+            direction = cross_product(v3._position - v0._position, v2._position - v0._position);
+            continue;
+        }
+
+        portal_found = true;
+        break;
+    }
+
+    // no portal within the iterations, the answer is unknown
+    if(!portal_found) {
+        return GJK_NOT_CONVERGED_BIT;
+    }
+
+    // phase 2, portal refinement
+
+    bool intersecting = false;
+    bool converged = false;
+    auto normal = direction;
+    for(; iter < max_iter_; ++iter)
+    {
+        if(is_parallel(v2._position - v1._position, v3._position - v1._position)) {
+            // the portal collapsed to a segment, it has no normal and nothing tells whether 
+            // the origin is on it. GJK decides and EPA expands its simplex.
+            return epa_penetration(alpha_, beta_, result_, nullptr, max_iter_, tolerance_);
+        }
+        normal = normalized(cross_product(v2._position - v1._position, v3._position - v1._position));
+
+        // origin is behind the portal, inside the minkowski difference. for the boolean 
+        // answer we could stop here, we keep refining to get the portal on the boundary.
+        if(dot_product(normal, v1._position) >= 0) {
+            intersecting = true;
+        }
+
+        const auto v4 = find_minkowski_support(normal, alpha_, beta_, &v3);
+        const auto v4_distance = dot_product(v4._position, normal);
+
+        // the origin is outside of the support plane
+        if(!intersecting && v4_distance <= 0) {
+            return GJK_EMPTY_MASK;
+        }
+
+        // portal is close enough to the boundary
+        if(v4_distance - dot_product(v3._position, normal) <= tolerance_) {
+            converged = true;
+            break;
+        }
+
+        // pick the new portal, out of the three candidate triangles the
+        // one the ray from v0 through the origin passes through.
+        const auto side = cross_product(v4._position, v0._position);
+        if(dot_product(v1._position, side) > 0) {
+            if(dot_product(v2._position, side) > 0) { v1 = v4; } else { v3 = v4; }
+        } else {
+            if(dot_product(v3._position, side) > 0) { v2 = v4; } else { v1 = v4; }
+        }
+    }
+
+    if(!intersecting) {
+        return converged ? GJK_EMPTY_MASK : GJK_NOT_CONVERGED_BIT;
+    }
+
+    // depth is the distance of the portal plane from the origin, witness points from 
+    // the origin projected on the portal.
+    const auto projection = closest_point_on_triangle(v1._position, v2._position, v3._position, 0, 1, 2);
+    const support_point* portal[3] = {&v1, &v2, &v3};
+
+    xfloat3 point_a{0, 0, 0};
+    xfloat3 point_b{0, 0, 0};
+    for(uint32_t i = 0; i < projection._count; ++i) {
+        point_a = point_a + portal[projection._indices[i]]->_support_a * projection._weights[i];
+        point_b = point_b + portal[projection._indices[i]]->_support_b * projection._weights[i];
+    }
+
+    // same convention as EPA, beta must be moved against the boundary normal
+    result_->_depth   = dot_product(normal, v1._position);
+    result_->_normal  = negate(normal);
+    result_->_point_a = point_a;
+    result_->_point_b = point_b;
+    
+    if(!converged) {
+        return static_cast<result_bits>(GJK_INTERSECTING_BIT | GJK_NOT_CONVERGED_BIT);
+    }
+    return GJK_INTERSECTING_BIT;
+}
+
+gjk::result_bits gjk::mpr_penetration(const mesh_object* alpha_, const mesh_object* beta_, contact_result* result_, uint32_t max_iter_, float tolerance_)
+{
+    if(const auto validation_error_bits = validate_objects(alpha_, beta_); validation_error_bits != GJK_EMPTY_MASK) {
+        return validation_error_bits;
+    }
+
+    assert(result_ && "'result_' can't be null");
+    *result_ = {};
+
+    if(object_margin_sum(alpha_, beta_) > 0) {
+        if(gjk::result_bits bits{}; margin_contact(alpha_, beta_, result_, max_iter_, bits)) {
+            return bits;
+        }
+    }
+
+    const auto bits = run_mpr(alpha_, beta_, result_, max_iter_, tolerance_);
+    if(contains(bits, GJK_INTERSECTING_BIT)) {
+        inflate_contact(alpha_, beta_, result_);
+    }
+    return bits;
+}
+
+gjk::result_bits gjk::collide(const mesh_object* alpha_, const mesh_object* beta_, narrowphase_algorithm algorithm_, contact_result* result_, epa_scratch* scratch_, uint32_t max_iter_)
+{
+    switch(algorithm_)
+    {
+        case GJK_ALGORITHM_MPR:     return mpr_penetration(alpha_, beta_, result_, max_iter_);
+        case GJK_ALGORITHM_GJK_EPA: 
+        default:                    return penetration(alpha_, beta_, result_, scratch_, max_iter_);
+    }
+}
+
+// vertex data the support search of the object reads
+static const void* object_shape_key(const gjk::mesh_object* object_)
+{
+    if(is_primitive(object_)) {
+        return nullptr;
+    }
+    return object_->_convex_shape ? static_cast<const void*>(object_->_convex_shape) : static_cast<const void*>(object_->_vertices);
+}
+
+void gjk::intersects_batch(std::span<const mesh_object> objects_, std::span<const object_pair> pairs_, std::span<result_bits> results_, batch_scratch* scratch_, const batch_options& options_)
+{
+    assert(results_.size() >= pairs_.size() && "'results_' must have a slot for each pair");
+
+    batch_scratch local_scratch{};
+    auto& scratch = scratch_ ? *scratch_ : local_scratch;
+
+    const auto object_count = static_cast<uint32_t>(objects_.size());
+    const auto pair_count   = static_cast<uint32_t>(pairs_.size());
+
+    // per object validation, done once instead of once per pair
+    scratch._object_bits.resize(object_count);
+    for(uint32_t i = 0; i < object_count; ++i) {
+        const auto& object_ = objects_[i];
+        scratch._object_bits[i] = validate_object_vertices(&object_);
+    }
+
+    scratch._order.resize(pair_count);
+    for(uint32_t i = 0; i < pair_count; ++i) {
+        scratch._order[i] = i;
+    }
+
+    if(options_._group_by_shape) {
+        const auto shape_of = [&](uint32_t index) {
+            return index < object_count ? object_shape_key(&objects_[index]) : nullptr;
+        };
+        std::sort(scratch._order.begin(), scratch._order.end(), [&](uint32_t lhs, uint32_t rhs) {
+            const auto& l = pairs_[lhs];
+            const auto& r = pairs_[rhs];
+            const auto la = shape_of(l._a), ra = shape_of(r._a);
+            if(la != ra) return std::less<const void*>()(la, ra);
+            return std::less<const void*>()(shape_of(l._b), shape_of(r._b));
+        });
+    }
+
+    // only the answer is needed, smallest simplex vertices
+    fixed_list<basic_support_point<false>, 4> simplex{};
+    for(const auto pair_index : scratch._order)
+    {
+        const auto& pair = pairs_[pair_index];
+        
+        if(pair._a >= object_count || pair._b >= object_count) {
+            results_[pair_index] = static_cast<result_bits>(GJK_INVALID_BIT | GJK_ERROR_NULL_OBJECT_BIT);
+            continue;
+        }
+
+        if(pair._a == pair._b) {
+            results_[pair_index] = static_cast<result_bits>(GJK_INVALID_BIT | GJK_ERROR_SAME_OBJECT_BIT);
+            continue;
+        }
+
+        const auto alpha_ = &objects_[pair._a];
+        const auto beta_  = &objects_[pair._b];
+
+        std::underlying_type<gjk::result_bits>::type validation_error_bits = 
+            scratch._object_bits[pair._a] | scratch._object_bits[pair._b] |
+            mask_if_false<GJK_ERROR_SAME_VERTEX_ARRAY_BIT>(!shares_raw_vertices(alpha_, beta_));
+
+        if(validation_error_bits != GJK_EMPTY_MASK) {
+            results_[pair_index] = static_cast<result_bits>(validation_error_bits | GJK_INVALID_BIT);
+            continue;
+        }
+
+        if(bounds_separated(alpha_, beta_)) {
+            results_[pair_index] = GJK_EMPTY_MASK;
+            continue;
+        }
+
+        if(object_margin_sum(alpha_, beta_) > 0) {
+            results_[pair_index] = run_gjk_margin(alpha_, beta_, options_._max_iter);
+            continue;
+        }
+
+        results_[pair_index] = run_gjk<gjk::boolean_policy>(alpha_, beta_, options_._max_iter, nullptr, nullptr, simplex);
+    }
+}
@@ -0,0 +1,510 @@
+///////////////////////////////////////////////////////////////////
+// Convex shape cooking, vertex welding and convex hull (quickhull)
+///////////////////////////////////////////////////////////////////
+
+#include "cg_gjk.hpp"
+#include <vector>
+#include <unordered_map>
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+
+using namespace s2cpp;
+using namespace mxlib;
+
+// cooking is a one-time cost, we run the hull construction in double precision
+// to keep the orientation tests robust for nearly coplanar points.
+struct dvec3
+{
+    double x{}, y{}, z{};
+};
+
+static dvec3  sub  (const dvec3& a, const dvec3& b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+static double dot  (const dvec3& a, const dvec3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+static dvec3  cross(const dvec3& a, const dvec3& b)
+{
+    return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+
+struct hull_face
+{
+    uint32_t
+    _v[3]{};
+
+    dvec3
+    _normal{};
+
+    double
+    _offset{};
+
+    // points in front of the face, not yet part of the hull
+    std::vector<uint32_t>
+    _outside{};
+
+    bool
+    _alive{true};
+
+    bool
+    _visible{false};
+};
+
+static uint64_t edge_key(uint32_t a, uint32_t b)
+{
+    return (static_cast<uint64_t>(a) << 32) | b;
+}
+
+static double plane_distance(const hull_face& face, const dvec3& p)
+{
+    return dot(face._normal, p) - face._offset;
+}
+
+// merges vertices closer than 'tolerance' using a uniform hash grid,
+// neighbouring cells are checked so points near a cell border are welded too.
+static std::vector<xfloat3> weld_vertices(const xfloat3* vertices_, uint32_t vertex_count_, float tolerance)
+{
+    std::vector<xfloat3> welded{};
+    welded.reserve(vertex_count_);
+
+    if(tolerance <= 0.0f) {
+        welded.assign(vertices_, vertices_ + vertex_count_);
+        return welded;
+    }
+
+    const auto cell_of = [tolerance](float v) { return static_cast<int64_t>(std::floor(v / tolerance)); };
+    const auto cell_key = [](int64_t x, int64_t y, int64_t z) {
+        // 21 bits per axis is plenty for a hull.
+        constexpr int64_t mask = (1 << 21) - 1;
+        return static_cast<uint64_t>((x & mask) | ((y & mask) << 21) | ((z & mask) << 42));
+    };
+
+    std::unordered_multimap<uint64_t, uint32_t> grid{};
+    grid.reserve(vertex_count_);
+
+    const auto tolerance_sq = tolerance * tolerance;
+    for(uint32_t i = 0; i < vertex_count_; ++i)
+    {
+        const auto& vertex_ = vertices_[i];
+        const auto cx = cell_of(vertex_.x), cy = cell_of(vertex_.y), cz = cell_of(vertex_.z);
+
+        bool duplicate = false;
+        for(int64_t x = cx - 1; x <= cx + 1 && !duplicate; ++x)
+        for(int64_t y = cy - 1; y <= cy + 1 && !duplicate; ++y)
+        for(int64_t z = cz - 1; z <= cz + 1 && !duplicate; ++z) {
+            const auto range = grid.equal_range(cell_key(x, y, z));
+            for(auto it = range.first; it != range.second; ++it) {
+                const auto d = welded[it->second] - vertex_;
+                if(dot_product(d, d) <= tolerance_sq) {
+                    duplicate = true;
+                    break;
+                }
+            }
+        }
+
+        if(!duplicate) {
+            grid.emplace(cell_key(cx, cy, cz), static_cast<uint32_t>(welded.size()));
+            welded.push_back(vertex_);
+        }
+    }
+
+    return welded;
+}
+
+struct gjk::convex_shape_builder
+{
+    static void clear(gjk::convex_shape* shape_);
+    static gjk::cook_result_bits build(const std::vector<xfloat3>& points_, gjk::convex_shape* shape_, double epsilon_scale);
+    static void build_adjacency(gjk::convex_shape* shape_);
+    static void build_direction_lut(gjk::convex_shape* shape_);
+};
+
+// every hull edge appears once in each direction in the closed triangle mesh,
+// so collecting the directed edges gives each vertex its neighbours exactly once.
+void gjk::convex_shape_builder::build_adjacency(gjk::convex_shape* shape_)
+{
+    const auto vertex_count = shape_->vertex_count();
+    const auto& indices = shape_->_indices;
+
+    auto& offsets = shape_->_adjacency_offsets;
+    auto& adjacency = shape_->_adjacency;
+
+    offsets.assign(vertex_count + 1, 0);
+    for(size_t i = 0; i < indices.size(); ++i) {
+        offsets[indices[i] + 1]++;
+    }
+    for(uint32_t i = 0; i < vertex_count; ++i) {
+        offsets[i + 1] += offsets[i];
+    }
+
+    std::vector<uint32_t> heads(offsets.begin(), offsets.end() - 1);
+    adjacency.resize(indices.size());
+    for(size_t t = 0; t < indices.size(); t += 3) {
+        for(uint32_t e = 0; e < 3; ++e) {
+            const auto a = indices[t + e];
+            const auto b = indices[t + (e + 1) % 3];
+            adjacency[heads[a]++] = b;
+        }
+    }
+}
+
+// inverse of 'direction_lut_cell', direction through the center of the cell
+static xfloat3 direction_lut_center(uint32_t cell)
+{
+    constexpr auto resolution = gjk::GJK_DIRECTION_LUT_RESOLUTION;
+
+    const auto iu   = cell % resolution;
+    const auto iv   = (cell / resolution) % resolution;
+    const auto face = cell / (resolution * resolution);
+
+    const auto u = (static_cast<float>(iu) + 0.5f) / resolution * 2.0f - 1.0f;
+    const auto v = (static_cast<float>(iv) + 0.5f) / resolution * 2.0f - 1.0f;
+    const auto sign = (face % 2 == 0) ? 1.0f : -1.0f;
+
+    switch(face / 2) {
+        case 0:  return xfloat3(sign, u, v);
+        case 1:  return xfloat3(u, sign, v);
+        default: return xfloat3(u, v, sign);
+    }
+}
+
+// neighbouring cells have nearly the same answer, so each cell is solved by
+// walking the hull from the previous cell's vertex instead of a full scan.
+void gjk::convex_shape_builder::build_direction_lut(gjk::convex_shape* shape_)
+{
+    const auto vertices  = shape_->vertices();
+    const auto offsets   = shape_->adjacency_offsets();
+    const auto adjacency = shape_->adjacency();
+
+    shape_->_direction_lut.resize(GJK_DIRECTION_LUT_CELL_COUNT);
+
+    uint32_t current = 0;
+    for(uint32_t cell = 0; cell < GJK_DIRECTION_LUT_CELL_COUNT; ++cell)
+    {
+        const auto direction = direction_lut_center(cell);
+        auto best_match = dot_product(direction, vertices[current]);
+
+        for(uint32_t next = current;; current = next) {
+            for(uint32_t k = offsets[current]; k < offsets[current + 1]; ++k) {
+                const auto dot = dot_product(direction, vertices[adjacency[k]]);
+                if(dot > best_match) {
+                    best_match = dot;
+                    next = adjacency[k];
+                }
+            }
+            if(next == current) break;
+        }
+
+        shape_->_direction_lut[cell] = current;
+    }
+}
+
+// drops everything derived from a previous cook, a re-cooked shape must not keep 
+// the adjacency or direction table of the old hull, a failed cook leaves it empty.
+void gjk::convex_shape_builder::clear(gjk::convex_shape* shape_)
+{
+    shape_->_vertices.clear();
+    shape_->_indices.clear();
+    shape_->_soa = {};
+    shape_->_center = xfloat3(0, 0, 0);
+    shape_->_local_bounds = {};
+    shape_->_sphere_center = xfloat3(0, 0, 0);
+    shape_->_sphere_radius = 0;
+    shape_->_adjacency_offsets.clear();
+    shape_->_adjacency.clear();
+    shape_->_direction_lut.clear();
+}
+
+gjk::cook_result_bits gjk::convex_shape_builder::build(const std::vector<xfloat3>& points_, gjk::convex_shape* shape_, double epsilon_scale)
+{
+    clear(shape_);
+
+    const auto count = static_cast<uint32_t>(points_.size());
+
+    std::vector<dvec3> points(count);
+    double max_extent = 0.0;
+    for(uint32_t i = 0; i < count; ++i) {
+        points[i] = {points_[i].x, points_[i].y, points_[i].z};
+        max_extent = std::max({max_extent, std::abs(points[i].x), std::abs(points[i].y), std::abs(points[i].z)});
+    }
+
+    // distance tolerance relative to the size of the input.
+    const double epsilon = epsilon_scale * std::max(max_extent, 1.0);
+
+    //
+    // initial tetrahedron
+    //
+
+    // pick the most distant pair of the axis extremes
+    uint32_t extremes[6]{};
+    for(uint32_t i = 1; i < count; ++i) {
+        const auto& p = points[i];
+        if(p.x < points[extremes[0]].x) extremes[0] = i;
+        if(p.x > points[extremes[1]].x) extremes[1] = i;
+        if(p.y < points[extremes[2]].y) extremes[2] = i;
+        if(p.y > points[extremes[3]].y) extremes[3] = i;
+        if(p.z < points[extremes[4]].z) extremes[4] = i;
+        if(p.z > points[extremes[5]].z) extremes[5] = i;
+    }
+
+    uint32_t i0 = 0, i1 = 0;
+    double best = -1.0;
+    for(uint32_t a = 0; a < 6; ++a) {
+        for(uint32_t b = a + 1; b < 6; ++b) {
+            const auto d = sub(points[extremes[b]], points[extremes[a]]);
+            if(dot(d, d) > best) {
+                best = dot(d, d);
+                i0 = extremes[a];
+                i1 = extremes[b];
+            }
+        }
+    }
+
+    if(best <= epsilon * epsilon) {
+        return static_cast<cook_result_bits>(GJK_COOK_INVALID_BIT | GJK_COOK_ERROR_DEGENERATE_BIT);
+    }
+
+    // the furthest point from the line
+    uint32_t i2 = 0;
+    best = -1.0;
+    const auto line = sub(points[i1], points[i0]);
+    for(uint32_t i = 0; i < count; ++i) {
+        const auto c = cross(line, sub(points[i], points[i0]));
+        if(dot(c, c) > best) {
+            best = dot(c, c);
+            i2 = i;
+        }
+    }
+
+    if(best <= epsilon * epsilon * dot(line, line)) {
+        return static_cast<cook_result_bits>(GJK_COOK_INVALID_BIT | GJK_COOK_ERROR_DEGENERATE_BIT);
+    }
+
+    // the furthest point from the plane
+    uint32_t i3 = 0;
+    best = 0.0;
+    const auto plane_normal = cross(line, sub(points[i2], points[i0]));
+    const auto plane_length = std::sqrt(dot(plane_normal, plane_normal));
+    for(uint32_t i = 0; i < count; ++i) {
+        const auto d = dot(plane_normal, sub(points[i], points[i0])) / plane_length;
+        if(std::abs(d) > std::abs(best)) {
+            best = d;
+            i3 = i;
+        }
+    }
+
+    if(std::abs(best) <= epsilon) {
+        return static_cast<cook_result_bits>(GJK_COOK_INVALID_BIT | GJK_COOK_ERROR_DEGENERATE_BIT);
+    }
+
+    // the fourth point must be behind the first face
+    if(best > 0.0) {
+        std::swap(i1, i2);
+    }
+
+    std::vector<hull_face> faces{};
+    std::unordered_map<uint64_t, uint32_t> edges{};
+
+    const auto add_face = [&](uint32_t a, uint32_t b, uint32_t c)
+    {
+        hull_face face{};
+        face._v[0] = a;
+        face._v[1] = b;
+        face._v[2] = c;
+
+        const auto n = cross(sub(points[b], points[a]), sub(points[c], points[a]));
+        const auto l = std::sqrt(dot(n, n));
+        face._normal = l > 0.0 ? dvec3{n.x / l, n.y / l, n.z / l} : dvec3{};
+        face._offset = dot(face._normal, points[a]);
+
+        const auto index = static_cast<uint32_t>(faces.size());
+        edges[edge_key(a, b)] = index;
+        edges[edge_key(b, c)] = index;
+        edges[edge_key(c, a)] = index;
+        faces.push_back(std::move(face));
+        return index;
+    };
+
+    add_face(i0, i1, i2);
+    add_face(i0, i3, i1);
+    add_face(i1, i3, i2);
+    add_face(i2, i3, i0);
+
+    // assign rest of the points to outside sets
+    for(uint32_t i = 0; i < count; ++i) {
+        if(i == i0 || i == i1 || i == i2 || i == i3) continue;
+        for(auto& face : faces) {
+            if(plane_distance(face, points[i]) > epsilon) {
+                face._outside.push_back(i);
+                break;
+            }
+        }
+    }
+
+    //
+    // quickhull
+    //
+
+    std::vector<uint32_t> visible{};
+    std::vector<uint32_t> stack{};
+    std::vector<std::pair<uint32_t, uint32_t>> horizon{};
+    std::vector<uint32_t> orphans{};
+
+    for(uint32_t face_index = 0; face_index < faces.size(); ++face_index)
+    {
+        if(!faces[face_index]._alive || faces[face_index]._outside.empty()) {
+            continue;
+        }
+
+        // the furthest outside point is guaranteed to be on the hull
+        uint32_t eye = faces[face_index]._outside[0];
+        double   eye_distance = plane_distance(faces[face_index], points[eye]);
+        for(auto i : faces[face_index]._outside) {
+            const auto d = plane_distance(faces[face_index], points[i]);
+            if(d > eye_distance) {
+                eye_distance = d;
+                eye = i;
+            }
+        }
+
+        // flood fill the connected set of faces visible from the eye point,
+        // edges between visible and hidden faces form the horizon.
+        visible.clear();
+        horizon.clear();
+        stack.clear();
+        stack.push_back(face_index);
+        faces[face_index]._visible = true;
+
+        while(!stack.empty()) {
+            const auto current = stack.back();
+            stack.pop_back();
+            visible.push_back(current);
+
+            for(uint32_t e = 0; e < 3; ++e) {
+                const auto a = faces[current]._v[e];
+                const auto b = faces[current]._v[(e + 1) % 3];
+                const auto neighbour = edges.at(edge_key(b, a));
+
+                if(faces[neighbour]._visible) {
+                    continue;
+                }
+
+                if(plane_distance(faces[neighbour], points[eye]) > epsilon) {
+                    faces[neighbour]._visible = true;
+                    stack.push_back(neighbour);
+                } else {
+                    horizon.emplace_back(a, b);
+                }
+            }
+        }
+
+        // remove visible faces, their outside points need a new home
+        orphans.clear();
+        for(auto v : visible) {
+            auto& face = faces[v];
+            face._alive   = false;
+            face._visible = false;
+            for(uint32_t e = 0; e < 3; ++e) {
+                const auto key = edge_key(face._v[e], face._v[(e + 1) % 3]);
+                const auto it  = edges.find(key);
+                if(it != edges.end() && it->second == v) {
+                    edges.erase(it);
+                }
+            }
+            for(auto i : face._outside) {
+                if(i != eye) orphans.push_back(i);
+            }
+            face._outside.clear();
+            face._outside.shrink_to_fit();
+        }
+
+        // connect the horizon to the eye point
+        const auto first_new = static_cast<uint32_t>(faces.size());
+        for(const auto& [a, b] : horizon) {
+            add_face(a, b, eye);
+        }
+
+        for(auto i : orphans) {
+            for(auto f = first_new; f < faces.size(); ++f) {
+                if(plane_distance(faces[f], points[i]) > epsilon) {
+                    faces[f]._outside.push_back(i);
+                    break;
+                }
+            }
+        }
+    }
+
+    //
+    // output, compact the hull vertices
+    //
+
+    std::vector<uint32_t> remap(count, UINT32_MAX);
+
+    for(const auto& face : faces) {
+        if(!face._alive) continue;
+        for(auto v : face._v) {
+            if(remap[v] == UINT32_MAX) {
+                remap[v] = static_cast<uint32_t>(shape_->_vertices.size());
+                shape_->_vertices.push_back(points_[v]);
+            }
+            shape_->_indices.push_back(remap[v]);
+        }
+    }
+
+    xfloat3 center{0, 0, 0};
+    for(const auto& vertex_ : shape_->_vertices) {
+        center = center + vertex_;
+    }
+    shape_->_center = center * (1.0f / static_cast<float>(shape_->_vertices.size()));
+
+    // bounds for the early rejection of far apart pairs
+    auto& bounds = shape_->_local_bounds;
+    bounds = gjk::aabb{ shape_->_vertices[0], shape_->_vertices[0] };
+    for(const auto& vertex_ : shape_->_vertices) {
+        bounds._min = xfloat3(std::min(bounds._min.x, vertex_.x), std::min(bounds._min.y, vertex_.y), std::min(bounds._min.z, vertex_.z));
+        bounds._max = xfloat3(std::max(bounds._max.x, vertex_.x), std::max(bounds._max.y, vertex_.y), std::max(bounds._max.z, vertex_.z));
+    }
+
+    shape_->_sphere_center = (bounds._min + bounds._max) * 0.5f;
+    auto radius_sq = 0.0f;
+    for(const auto& vertex_ : shape_->_vertices) {
+        const auto d = vertex_ - shape_->_sphere_center;
+        radius_sq = std::max(radius_sq, dot_product(d, d));
+    }
+    shape_->_sphere_radius = std::sqrt(radius_sq);
+
+    shape_->_vertices.shrink_to_fit();
+    shape_->_indices.shrink_to_fit();
+    build_soa_vertices(shape_->_vertices.data(), shape_->vertex_count(), &shape_->_soa);
+
+    return GJK_COOK_EMPTY_MASK;
+}
+
+gjk::cook_result_bits gjk::cook_convex(const xfloat3* vertices_, const uint32_t vertex_count_, convex_shape* shape_, const cook_options& options_)
+{
+    std::underlying_type<gjk::cook_result_bits>::type validation_error_bits = GJK_COOK_EMPTY_MASK;
+    if(!vertices_)         validation_error_bits |= GJK_COOK_ERROR_NULL_VERTEX_ARRAY_BIT;
+    if(!shape_)            validation_error_bits |= GJK_COOK_ERROR_NULL_SHAPE_BIT;
+    if(vertex_count_ < 4)  validation_error_bits |= GJK_COOK_ERROR_NOT_ENOUGH_VERTICES_BIT;
+
+    if(validation_error_bits != GJK_COOK_EMPTY_MASK) {
+        validation_error_bits |= GJK_COOK_INVALID_BIT;
+        return static_cast<gjk::cook_result_bits>(validation_error_bits);
+    }
+
+    const auto welded = weld_vertices(vertices_, vertex_count_, options_._weld_tolerance);
+    if(welded.size() < 4) {
+        convex_shape_builder::clear(shape_);
+        return static_cast<gjk::cook_result_bits>(GJK_COOK_INVALID_BIT | GJK_COOK_ERROR_NOT_ENOUGH_VERTICES_BIT);
+    }
+
+    const auto result_bits = convex_shape_builder::build(welded, shape_, 1e-6);
+    if(result_bits == GJK_COOK_EMPTY_MASK) {
+        if(options_._build_adjacency || options_._build_direction_lut) {
+            convex_shape_builder::build_adjacency(shape_);
+        }
+        if(options_._build_direction_lut) {
+            convex_shape_builder::build_direction_lut(shape_);
+        }
+    }
+
+    return result_bits;
+}
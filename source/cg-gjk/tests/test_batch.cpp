@@ -0,0 +1,94 @@
+///////////////////////////////////////////////////////////////////
+// intersects_batch against the one pair at a time queries
+///////////////////////////////////////////////////////////////////
+
+#include "test_common.hpp"
+
+using namespace s2cpp;
+using namespace s2cpp::gjk_test;
+
+int main()
+{
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> position(-6.0f, 6.0f);
+    std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+    std::normal_distribution<float> normal{};
+
+    // hulls from small to large, the large ones take the hill climbing path
+    std::vector<gjk::convex_shape> shapes(4);
+    for(uint32_t k = 0; k < shapes.size(); ++k) {
+        std::vector<xfloat3> points{};
+        for(uint32_t i = 0; i < 8 + k * 60; ++i) {
+            const auto p = xfloat3(normal(rng), normal(rng), normal(rng));
+            points.push_back(p * (1.0f / length(p)));
+        }
+        GJK_CHECK(gjk::cook_convex(points.data(), static_cast<uint32_t>(points.size()), &shapes[k]) == gjk::GJK_COOK_EMPTY_MASK);
+    }
+
+    std::vector<gjk::mesh_object> objects(300);
+    for(auto& object_ : objects) {
+        object_._model_mtx = model_matrix(xfloat3(position(rng), position(rng), position(rng)), angle(rng));
+        object_._convex_shape = &shapes[rng() % shapes.size()];
+    }
+
+    std::vector<gjk::object_pair> pairs{};
+    for(uint32_t i = 0; i < objects.size(); ++i) {
+        for(uint32_t j = i + 1; j < objects.size(); ++j) {
+            if(rng() % 4 == 0) pairs.push_back({i, j});
+        }
+    }
+    // invalid pairs go through the same validation on every path
+    pairs.push_back({3, 3});
+    pairs.push_back({1, 100000});
+
+    // touching pairs, the duplicate support termination decides these
+    const auto touching = static_cast<uint32_t>(objects.size());
+    objects.push_back(objects[0]);
+    objects.back()._model_mtx = model_matrix(xfloat3(0, 0, 0));
+    objects.push_back(objects[0]);
+    objects.back()._primitive = gjk::primitive_shape{ gjk::GJK_PRIMITIVE_BOX, 0, 0, xfloat3(1, 1, 1) };
+    objects.back()._model_mtx = model_matrix(xfloat3(0, 0, 0));
+    objects.push_back(objects.back());
+    objects.back()._model_mtx = model_matrix(xfloat3(2, 0.5f, 0.25f));
+    pairs.push_back({touching + 1, touching + 2});
+
+    gjk::batch_scratch scratch{};
+    for(const uint32_t max_iter : {3u, 100u})
+    {
+        gjk::batch_options options{};
+        options._max_iter = max_iter;
+
+        std::vector<gjk::result_bits> reference(pairs.size());
+        gjk::intersects_batch(objects, pairs, reference, &scratch, options);
+
+        // one pair at a time path is the 'boolean_policy' kernel
+        for(size_t i = 0; i < pairs.size(); ++i) {
+            const auto& pair = pairs[i];
+            if(pair._a >= objects.size() || pair._b >= objects.size()) {
+                GJK_CHECK(reference[i] == (gjk::GJK_INVALID_BIT | gjk::GJK_ERROR_NULL_OBJECT_BIT));
+                continue;
+            }
+            const auto expected = gjk::intersects<gjk::boolean_policy>(&objects[pair._a], &objects[pair._b], max_iter);
+            GJK_CHECK(reference[i] == expected);
+        }
+
+        uint32_t intersecting = 0;
+        for(const auto bits : reference) {
+            intersecting += (bits & gjk::GJK_INTERSECTING_BIT) != 0;
+        }
+        GJK_CHECK(intersecting > 0 && intersecting < pairs.size());
+
+        // same answers in the input order, without the grouping and without a scratch
+        options._group_by_shape = false;
+        std::vector<gjk::result_bits> results(pairs.size());
+        gjk::intersects_batch(objects, pairs, results, &scratch, options);
+        GJK_CHECK(results == reference);
+
+        options._group_by_shape = true;
+        std::fill(results.begin(), results.end(), gjk::GJK_EMPTY_MASK);
+        gjk::intersects_batch(objects, pairs, results, nullptr, options);
+        GJK_CHECK(results == reference);
+    }
+
+    return finish("test_batch");
+}
@@ -0,0 +1,322 @@
+///////////////////////////////////////////////////////////////////
+// broadphases against the brute force O(n^2) bounds overlap pairs
+///////////////////////////////////////////////////////////////////
+
+#include "test_common.hpp"
+#include "cg_broadphase.hpp"
+
+using namespace s2cpp;
+using namespace s2cpp::gjk_test;
+
+// found by the standard algorithms through the namespace of 'object_pair'
+namespace s2cpp::gjk
+{
+    static bool operator==(const object_pair& a, const object_pair& b)
+    {
+        return a._a == b._a && a._b == b._b;
+    }
+
+    static bool operator<(const object_pair& a, const object_pair& b)
+    {
+        return a._a != b._a ? a._a < b._a : a._b < b._b;
+    }
+}
+
+static std::vector<gjk::object_pair> sorted(std::vector<gjk::object_pair> pairs_)
+{
+    std::sort(pairs_.begin(), pairs_.end());
+    return pairs_;
+}
+
+// every overlapping unordered pair as (min index, max index)
+static std::vector<gjk::object_pair> brute_force_pairs(std::span<const gjk::aabb> bounds_)
+{
+    std::vector<gjk::object_pair> pairs{};
+    for(uint32_t i = 0; i < bounds_.size(); ++i) {
+        for(uint32_t j = i + 1; j < bounds_.size(); ++j) {
+            if(gjk::overlaps(bounds_[i], bounds_[j])) pairs.push_back({i, j});
+        }
+    }
+    return pairs;
+}
+
+// pairs are unique and ordered as documented
+static bool well_formed(const std::vector<gjk::object_pair>& pairs_)
+{
+    const auto ordered = sorted(pairs_);
+    for(size_t i = 0; i < ordered.size(); ++i) {
+        if(ordered[i]._a >= ordered[i]._b) return false;
+        if(i > 0 && ordered[i] == ordered[i - 1]) return false;
+    }
+    return true;
+}
+
+// boxes, spheres and cooked hulls of mixed sizes spread over a cube of 'extent'
+static std::vector<gjk::mesh_object> scatter_objects(std::mt19937& rng, const uint32_t count, const float extent, const gjk::convex_shape* hull)
+{
+    std::uniform_real_distribution<float> position(-extent, extent);
+    std::uniform_real_distribution<float> size(0.2f, 1.5f);
+    std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+
+    std::vector<gjk::mesh_object> objects(count);
+    for(uint32_t i = 0; i < count; ++i) {
+        auto& object_ = objects[i];
+        object_._model_mtx = model_matrix(xfloat3(position(rng), position(rng), position(rng)), angle(rng));
+        switch(i % 3) {
+            case 0:  object_._primitive = gjk::primitive_shape{ gjk::GJK_PRIMITIVE_BOX, 0, 0, xfloat3(size(rng), size(rng), size(rng)) }; break;
+            case 1:  object_._primitive = gjk::primitive_shape{ gjk::GJK_PRIMITIVE_SPHERE, size(rng) }; break;
+            default: object_._convex_shape = hull; break;
+        }
+        // a few large ones overlap many others and reach the coarse levels of the grid
+        if(i % 50 == 0) {
+            object_._primitive = gjk::primitive_shape{ gjk::GJK_PRIMITIVE_BOX, 0, 0, xfloat3(6, 0.5f, 4) };
+        }
+    }
+    return objects;
+}
+
+static std::vector<gjk::aabb> bounds_of(std::span<const gjk::mesh_object> objects_)
+{
+    std::vector<gjk::aabb> bounds{};
+    for(const auto& object_ : objects_) {
+        bounds.push_back(gjk::world_bounds(object_));
+    }
+    return bounds;
+}
+
+static void move_some(std::mt19937& rng, std::vector<gjk::mesh_object>& objects_)
+{
+    std::uniform_real_distribution<float> step(-0.5f, 0.5f);
+    for(uint32_t i = 0; i < objects_.size(); i += 3) {
+        auto& m = objects_[i]._model_mtx;
+        m[3] += step(rng); m[7] += step(rng); m[11] += step(rng);
+    }
+    // far jumps, endpoints travel through the whole sweep axis
+    for(uint32_t i = 1; i < objects_.size(); i += 97) {
+        std::swap(objects_[i]._model_mtx, objects_[objects_.size() - i]._model_mtx);
+    }
+}
+
+static void test_sweep_and_prune(std::mt19937& rng, std::vector<gjk::mesh_object> objects)
+{
+    gjk::sweep_and_prune broadphase{};
+    for(uint32_t frame = 0; frame < 3; ++frame) {
+        broadphase.update(objects);
+        std::vector<gjk::object_pair> pairs{};
+        broadphase.find_pairs(pairs);
+        GJK_CHECK(well_formed(pairs));
+        GJK_CHECK(sorted(pairs) == brute_force_pairs(bounds_of(objects)));
+        move_some(rng, objects);
+    }
+
+    // objects removed between frames
+    objects.resize(objects.size() / 2);
+    broadphase.update(objects);
+    std::vector<gjk::object_pair> pairs{};
+    broadphase.find_pairs(pairs);
+    GJK_CHECK(sorted(pairs) == brute_force_pairs(bounds_of(objects)));
+}
+
+static void test_dynamic_aabb_tree(std::mt19937& rng, std::vector<gjk::mesh_object> objects)
+{
+    // the tree reports overlapping fat boxes, compared against those
+    gjk::dynamic_aabb_tree tree{};
+    std::vector<uint32_t> proxies{};
+    for(uint32_t i = 0; i < objects.size(); ++i) {
+        proxies.push_back(tree.create_proxy(gjk::world_bounds(objects[i]), i));
+    }
+
+    for(uint32_t frame = 0; frame < 3; ++frame)
+    {
+        std::vector<gjk::aabb> fat_bounds{};
+        for(uint32_t i = 0; i < objects.size(); ++i) {
+            GJK_CHECK(gjk::encloses(tree.fat_bounds(proxies[i]), gjk::world_bounds(objects[i])));
+            GJK_CHECK(tree.user(proxies[i]) == i);
+            fat_bounds.push_back(tree.fat_bounds(proxies[i]));
+        }
+
+        std::vector<gjk::object_pair> pairs{};
+        tree.find_pairs(pairs);
+        GJK_CHECK(well_formed(pairs));
+        GJK_CHECK(sorted(pairs) == brute_force_pairs(fat_bounds));
+
+        // balanced, far from the height of a list
+        GJK_CHECK(tree.height() < 4 * static_cast<int32_t>(std::log2(static_cast<float>(objects.size()))));
+
+        std::vector<uint32_t> users{};
+        tree.query(fat_bounds[0], users);
+        std::sort(users.begin(), users.end());
+        std::vector<uint32_t> expected{};
+        for(uint32_t i = 0; i < fat_bounds.size(); ++i) {
+            if(gjk::overlaps(fat_bounds[0], fat_bounds[i])) expected.push_back(i);
+        }
+        GJK_CHECK(users == expected);
+
+        move_some(rng, objects);
+        for(uint32_t i = 0; i < objects.size(); ++i) {
+            tree.move_proxy(proxies[i], gjk::world_bounds(objects[i]));
+        }
+    }
+
+    for(uint32_t i = 0; i < objects.size(); i += 2) {
+        tree.destroy_proxy(proxies[i]);
+    }
+    GJK_CHECK(tree.size() == objects.size() / 2);
+
+    std::vector<gjk::object_pair> pairs{};
+    tree.find_pairs(pairs);
+    std::vector<gjk::object_pair> expected{};
+    for(uint32_t i = 1; i < objects.size(); i += 2) {
+        for(uint32_t j = i + 2; j < objects.size(); j += 2) {
+            if(gjk::overlaps(tree.fat_bounds(proxies[i]), tree.fat_bounds(proxies[j]))) expected.push_back({i, j});
+        }
+    }
+    GJK_CHECK(sorted(pairs) == expected);
+}
+
+static void test_spatial_hash_grid(std::mt19937& rng, std::vector<gjk::mesh_object> objects)
+{
+    // more threads than cores exercises the worker pool everywhere, the small cells 
+    // give more entries than the bucket cap
+    for(const auto& [cell_size, threads] : {std::pair{1.0f, 1u}, std::pair{1.0f, 3u}, std::pair{0.1f, 3u}})
+    {
+        gjk::spatial_hash_grid grid(cell_size, threads);
+        for(uint32_t frame = 0; frame < 2; ++frame) {
+            grid.update(objects);
+            std::vector<gjk::object_pair> pairs{};
+            grid.find_pairs(pairs);
+            GJK_CHECK(well_formed(pairs));
+            GJK_CHECK(sorted(pairs) == brute_force_pairs(bounds_of(objects)));
+            move_some(rng, objects);
+        }
+    }
+}
+
+static void test_static_bvh(const std::vector<gjk::mesh_object>& statics, const std::vector<gjk::mesh_object>& moving)
+{
+    const auto static_bounds = bounds_of(statics);
+    const auto moving_bounds = bounds_of(moving);
+
+    std::vector<gjk::object_pair> expected{};
+    for(uint32_t i = 0; i < moving_bounds.size(); ++i) {
+        for(uint32_t j = 0; j < static_bounds.size(); ++j) {
+            if(gjk::overlaps(moving_bounds[i], static_bounds[j])) expected.push_back({i, j});
+        }
+    }
+
+    for(const uint32_t threads : {1u, 3u})
+    {
+        gjk::static_bvh bvh(threads);
+        bvh.build(statics);
+
+        // every primitive is in exactly one leaf
+        auto primitives = std::vector<uint32_t>(bvh.primitive_indices().begin(), bvh.primitive_indices().end());
+        std::sort(primitives.begin(), primitives.end());
+        GJK_CHECK(primitives.size() == statics.size());
+        for(uint32_t i = 0; i < primitives.size(); ++i) {
+            GJK_CHECK(primitives[i] == i);
+        }
+
+        std::vector<gjk::object_pair> pairs{};
+        bvh.find_pairs(moving, pairs);
+        GJK_CHECK(sorted(pairs) == expected);
+    }
+
+    // enough primitives for the parallel top levels, the same pairs as one thread
+    std::mt19937 rng(13);
+    std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+    std::uniform_real_distribution<float> size(0.1f, 1.0f);
+    std::vector<gjk::aabb> many(20000);
+    for(auto& box : many) {
+        const auto c = xfloat3(position(rng), position(rng), position(rng));
+        const auto h = xfloat3(size(rng), size(rng), size(rng));
+        box = gjk::aabb{ c - h, c + h };
+    }
+
+    std::vector<gjk::object_pair> many_expected{};
+    for(uint32_t i = 0; i < moving_bounds.size(); ++i) {
+        for(uint32_t j = 0; j < many.size(); ++j) {
+            if(gjk::overlaps(moving_bounds[i], many[j])) many_expected.push_back({i, j});
+        }
+    }
+    GJK_CHECK(!many_expected.empty());
+
+    for(const uint32_t threads : {1u, 4u})
+    {
+        gjk::static_bvh bvh(threads);
+        bvh.build(many);
+        GJK_CHECK(bvh.primitive_indices().size() == many.size());
+
+        std::vector<gjk::object_pair> pairs{};
+        bvh.find_pairs(moving_bounds, pairs);
+        GJK_CHECK(sorted(pairs) == many_expected);
+    }
+
+    // empty build answers nothing
+    gjk::static_bvh empty{};
+    empty.build(std::span<const gjk::aabb>{});
+    std::vector<uint32_t> hits{};
+    empty.query(moving_bounds[0], hits);
+    GJK_CHECK(hits.empty());
+}
+
+static bool same_box(const gjk::aabb& a, const gjk::aabb& b)
+{
+    return length(a._min - b._min) <= 1e-5f && length(a._max - b._max) <= 1e-5f;
+}
+
+static void test_bounds_cache(const gjk::convex_shape* hull)
+{
+    gjk::mesh_object object_{};
+    object_._model_mtx    = model_matrix(xfloat3(1, 2, 3), 0.5f);
+    object_._convex_shape = hull;
+    const auto before = gjk::world_bounds(object_);
+
+    // queries don't fill the cache, 'update_bounds' does
+    GJK_CHECK(!object_._bounds_cache._valid);
+    gjk::update_bounds(object_);
+    GJK_CHECK(object_._bounds_cache._valid && same_box(object_._bounds_cache._box, before));
+
+    // moved without an update, the stale cache is not used
+    object_._model_mtx = model_matrix(xfloat3(11, 2, 3), 0.5f);
+    const auto moved = gjk::world_bounds(object_);
+    GJK_CHECK(same_box(moved, gjk::aabb{ before._min + xfloat3(10, 0, 0), before._max + xfloat3(10, 0, 0) }));
+    GJK_CHECK(same_box(object_._bounds_cache._box, before));
+
+    gjk::mesh_object probe{};
+    probe._model_mtx = model_matrix(xfloat3(11, 2, 3));
+    probe._primitive = gjk::primitive_shape{ gjk::GJK_PRIMITIVE_SPHERE, 0.5f };
+    gjk::update_bounds(probe);
+    GJK_CHECK(gjk::intersects(&object_, &probe) & gjk::GJK_INTERSECTING_BIT);
+
+    // the update follows the matrix
+    gjk::update_bounds(object_);
+    GJK_CHECK(same_box(object_._bounds_cache._box, moved));
+    GJK_CHECK(gjk::intersects(&object_, &probe) & gjk::GJK_INTERSECTING_BIT);
+
+    // raw vertices have no cached bounds
+    auto corners = box_corners(1.0f);
+    gjk::mesh_object raw{ model_matrix(xfloat3(0, 0, 0)), corners.data(), 8 };
+    gjk::update_bounds(raw);
+    GJK_CHECK(!raw._bounds_cache._valid);
+    GJK_CHECK(same_box(gjk::world_bounds(raw), gjk::aabb{ xfloat3(-1, -1, -1), xfloat3(1, 1, 1) }));
+}
+
+int main()
+{
+    std::mt19937 rng(11);
+
+    gjk::convex_shape hull{};
+    const auto hull_points = sphere_points(40);
+    GJK_CHECK(gjk::cook_convex(hull_points.data(), static_cast<uint32_t>(hull_points.size()), &hull) == gjk::GJK_COOK_EMPTY_MASK);
+
+    const auto objects = scatter_objects(rng, 1500, 20.0f, &hull);
+
+    test_sweep_and_prune(rng, objects);
+    test_dynamic_aabb_tree(rng, objects);
+    test_spatial_hash_grid(rng, objects);
+    test_static_bvh(objects, scatter_objects(rng, 300, 20.0f, &hull));
+    test_bounds_cache(&hull);
+
+    return finish("test_broadphase");
+}
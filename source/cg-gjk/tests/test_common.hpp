@@ -0,0 +1,93 @@
+///////////////////////////////////////////////////////////////////
+// Shared helpers of the cg-gjk tests, no test framework needed
+///////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "cg_gjk.hpp"
+
+#include <cstdio>
+#include <cmath>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <limits>
+
+namespace s2cpp::gjk_test
+{
+    inline int& failure_count()
+    {
+        static int count = 0;
+        return count;
+    }
+
+    inline void report_failure(const char* file, const int line, const char* expression)
+    {
+        std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+        ++failure_count();
+    }
+
+    // exit code of the test executable, ctest fails the test on non-zero
+    inline int finish(const char* name)
+    {
+        if(failure_count() > 0) {
+            std::fprintf(stderr, "%s: %d check(s) failed\n", name, failure_count());
+            return 1;
+        }
+        std::printf("%s: ok\n", name);
+        return 0;
+    }
+
+    // model matrix, rotation of 'angle' radians around the z axis, translation and uniform scale
+    inline xfloat4x4 model_matrix(const xfloat3& translation, const float angle = 0.0f, const float scale = 1.0f)
+    {
+        xfloat4x4 m{};
+        const auto c = std::cos(angle) * scale;
+        const auto s = std::sin(angle) * scale;
+        m[0] = c; m[1] = -s; m[2]  = 0;     m[3]  = translation.x;
+        m[4] = s; m[5] = c;  m[6]  = 0;     m[7]  = translation.y;
+        m[8] = 0; m[9] = 0;  m[10] = scale; m[11] = translation.z;
+        m[15] = 1;
+        return m;
+    }
+
+    // corners of the axis aligned box with 'half_extent'
+    inline std::vector<xfloat3> box_corners(const float half_extent)
+    {
+        std::vector<xfloat3> corners{};
+        for(uint32_t i = 0; i < 8; ++i) {
+            corners.push_back(xfloat3(
+                i & 1 ? half_extent : -half_extent,
+                i & 2 ? half_extent : -half_extent,
+                i & 4 ? half_extent : -half_extent));
+        }
+        return corners;
+    }
+
+    // evenly spread points on the unit sphere
+    inline std::vector<xfloat3> sphere_points(const uint32_t count)
+    {
+        constexpr float golden_angle = 2.39996323f;
+        std::vector<xfloat3> points{};
+        for(uint32_t i = 0; i < count; ++i) {
+            const auto y = 1.0f - 2.0f * (static_cast<float>(i) + 0.5f) / static_cast<float>(count);
+            const auto r = std::sqrt(1.0f - y * y);
+            const auto a = golden_angle * static_cast<float>(i);
+            points.push_back(xfloat3(std::cos(a) * r, y, std::sin(a) * r));
+        }
+        return points;
+    }
+
+    inline float length(const xfloat3& v)
+    {
+        return std::sqrt(dot_product(v, v));
+    }
+}
+
+#define GJK_CHECK(expression) \
+    do { if(!(expression)) { s2cpp::gjk_test::report_failure(__FILE__, __LINE__, #expression); } } while(0)
+
+#define GJK_CHECK_NEAR(a, b, tolerance) \
+    do { if(!(std::abs((a) - (b)) <= (tolerance))) { \
+        std::fprintf(stderr, "    %g vs %g\n", static_cast<double>(a), static_cast<double>(b)); \
+        s2cpp::gjk_test::report_failure(__FILE__, __LINE__, #a " ~ " #b); } } while(0)
@@ -0,0 +1,177 @@
+///////////////////////////////////////////////////////////////////
+// cook_convex, quickhull on hulls with known answers
+///////////////////////////////////////////////////////////////////
+
+#include "test_common.hpp"
+
+#include <set>
+#include <utility>
+
+using namespace s2cpp;
+using namespace s2cpp::gjk_test;
+
+// closed, consistently wound triangle mesh with every input point behind every face
+static void check_hull(const gjk::convex_shape& shape_, const std::vector<xfloat3>& points_)
+{
+    const auto vertices = shape_.vertices();
+    const auto indices  = shape_.indices();
+
+    std::set<std::pair<uint32_t, uint32_t>> edges{};
+    for(uint32_t t = 0; t < shape_.triangle_count(); ++t)
+    {
+        const auto& a = vertices[indices[3 * t]];
+        const auto& b = vertices[indices[3 * t + 1]];
+        const auto& c = vertices[indices[3 * t + 2]];
+        const auto normal = cross_product(b - a, c - a);
+        const auto normal_length = length(normal);
+        GJK_CHECK(normal_length > 0);
+
+        uint32_t outside = 0;
+        for(const auto& p : points_) {
+            outside += dot_product(normal, p - a) > 1e-4f * normal_length;
+        }
+        GJK_CHECK(outside == 0);
+
+        for(uint32_t k = 0; k < 3; ++k) {
+            GJK_CHECK(edges.insert({indices[3 * t + k], indices[3 * t + (k + 1) % 3]}).second);
+        }
+    }
+
+    // every directed edge has its twin, the mesh is closed
+    for(const auto& [from, to] : edges) {
+        GJK_CHECK(edges.count({to, from}) == 1);
+    }
+
+    // euler characteristic of a sphere
+    const auto euler = static_cast<int32_t>(shape_.vertex_count()) - static_cast<int32_t>(edges.size() / 2) + static_cast<int32_t>(shape_.triangle_count());
+    GJK_CHECK(euler == 2);
+
+    // bounds and bounding sphere enclose the hull
+    for(uint32_t i = 0; i < shape_.vertex_count(); ++i) {
+        const auto& bounds = shape_.local_bounds();
+        GJK_CHECK(bounds._min.x <= vertices[i].x && bounds._min.y <= vertices[i].y && bounds._min.z <= vertices[i].z);
+        GJK_CHECK(vertices[i].x <= bounds._max.x && vertices[i].y <= bounds._max.y && vertices[i].z <= bounds._max.z);
+        GJK_CHECK(length(vertices[i] - shape_.sphere_center()) <= shape_.sphere_radius() * 1.0001f);
+    }
+}
+
+static void test_cube(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> inside(-0.99f, 0.99f);
+
+    // corners three times over, interior points and points on the faces and edges
+    std::vector<xfloat3> points{};
+    for(uint32_t repeat = 0; repeat < 3; ++repeat) {
+        for(const auto& corner : box_corners(1.0f)) points.push_back(corner);
+    }
+    for(uint32_t i = 0; i < 500; ++i) {
+        points.push_back(xfloat3(inside(rng), inside(rng), inside(rng)));
+    }
+    for(uint32_t i = 0; i < 50; ++i) {
+        points.push_back(xfloat3(inside(rng), inside(rng), 1.0f));
+        points.push_back(xfloat3(1.0f, -1.0f, inside(rng)));
+    }
+
+    gjk::convex_shape shape{};
+    GJK_CHECK(gjk::cook_convex(points.data(), static_cast<uint32_t>(points.size()), &shape) == gjk::GJK_COOK_EMPTY_MASK);
+    GJK_CHECK(shape.vertex_count() == 8);
+    GJK_CHECK(shape.triangle_count() == 12);
+    check_hull(shape, points);
+
+    // only the corners are kept
+    for(uint32_t i = 0; i < shape.vertex_count(); ++i) {
+        const auto& v = shape.vertices()[i];
+        GJK_CHECK(std::abs(v.x) == 1.0f && std::abs(v.y) == 1.0f && std::abs(v.z) == 1.0f);
+    }
+
+    GJK_CHECK(length(shape.local_bounds()._min - xfloat3(-1, -1, -1)) == 0);
+    GJK_CHECK(length(shape.local_bounds()._max - xfloat3(1, 1, 1)) == 0);
+    GJK_CHECK_NEAR(shape.sphere_radius(), std::sqrt(3.0f), 1e-5f);
+}
+
+static void test_octahedron_and_tetrahedron(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> inside(-0.3f, 0.3f);
+
+    std::vector<xfloat3> octahedron = { {2, 0, 0}, {-2, 0, 0}, {0, 2, 0}, {0, -2, 0}, {0, 0, 2}, {0, 0, -2} };
+    for(uint32_t i = 0; i < 100; ++i) {
+        octahedron.push_back(xfloat3(inside(rng), inside(rng), inside(rng)));
+    }
+
+    gjk::convex_shape shape{};
+    GJK_CHECK(gjk::cook_convex(octahedron.data(), static_cast<uint32_t>(octahedron.size()), &shape) == gjk::GJK_COOK_EMPTY_MASK);
+    GJK_CHECK(shape.vertex_count() == 6);
+    GJK_CHECK(shape.triangle_count() == 8);
+    check_hull(shape, octahedron);
+
+    const std::vector<xfloat3> tetrahedron = { {0, 0, 0}, {1, 0, 0}, {0, 1, 0}, {0, 0, 1}, {0.1f, 0.1f, 0.1f} };
+    GJK_CHECK(gjk::cook_convex(tetrahedron.data(), static_cast<uint32_t>(tetrahedron.size()), &shape) == gjk::GJK_COOK_EMPTY_MASK);
+    GJK_CHECK(shape.vertex_count() == 4);
+    GJK_CHECK(shape.triangle_count() == 4);
+    check_hull(shape, tetrahedron);
+}
+
+static void test_sphere_points()
+{
+    // every point is on the hull, triangles of a closed mesh are 2V - 4
+    const auto points = sphere_points(300);
+
+    gjk::convex_shape shape{};
+    GJK_CHECK(gjk::cook_convex(points.data(), static_cast<uint32_t>(points.size()), &shape) == gjk::GJK_COOK_EMPTY_MASK);
+    GJK_CHECK(shape.vertex_count() == 300);
+    GJK_CHECK(shape.triangle_count() == 2 * 300 - 4);
+    check_hull(shape, points);
+    GJK_CHECK(shape.has_adjacency());
+}
+
+static void test_errors()
+{
+    gjk::convex_shape shape{};
+
+    const std::vector<xfloat3> flat = { {0, 0, 0}, {1, 0, 0}, {0, 1, 0}, {1, 1, 0}, {0.5f, 0.5f, 0} };
+    GJK_CHECK(gjk::cook_convex(flat.data(), static_cast<uint32_t>(flat.size()), &shape) & gjk::GJK_COOK_ERROR_DEGENERATE_BIT);
+
+    const std::vector<xfloat3> welded = { {0, 0, 0}, {0, 0, 0}, {1e-6f, 0, 0}, {1, 0, 0}, {0, 1, 0} };
+    GJK_CHECK(gjk::cook_convex(welded.data(), static_cast<uint32_t>(welded.size()), &shape) & gjk::GJK_COOK_ERROR_NOT_ENOUGH_VERTICES_BIT);
+    GJK_CHECK(gjk::cook_convex(nullptr, 8, &shape) & gjk::GJK_COOK_ERROR_NULL_VERTEX_ARRAY_BIT);
+    GJK_CHECK(gjk::cook_convex(flat.data(), 3, &shape) & gjk::GJK_COOK_ERROR_NOT_ENOUGH_VERTICES_BIT);
+}
+
+static void test_recook()
+{
+    gjk::convex_shape shape{};
+
+    // re-cook without the optional tables drops the old ones
+    const auto points = sphere_points(200);
+    gjk::cook_options with_lut{};
+    with_lut._build_direction_lut = true;
+    GJK_CHECK(gjk::cook_convex(points.data(), static_cast<uint32_t>(points.size()), &shape, with_lut) == gjk::GJK_COOK_EMPTY_MASK);
+    GJK_CHECK(shape.has_adjacency() && shape.has_direction_lut());
+
+    gjk::cook_options plain{};
+    plain._build_adjacency = false;
+    const auto cube = box_corners(1.0f);
+    GJK_CHECK(gjk::cook_convex(cube.data(), static_cast<uint32_t>(cube.size()), &shape, plain) == gjk::GJK_COOK_EMPTY_MASK);
+    GJK_CHECK(!shape.has_adjacency() && !shape.has_direction_lut());
+    GJK_CHECK(shape.vertex_count() == 8);
+    GJK_CHECK(shape.soa()._vertex_count == 8);
+
+    // failed cook leaves the shape empty
+    const std::vector<xfloat3> flat = { {0, 0, 0}, {1, 0, 0}, {0, 1, 0}, {1, 1, 0}, {0.5f, 0.5f, 0} };
+    GJK_CHECK(gjk::cook_convex(flat.data(), static_cast<uint32_t>(flat.size()), &shape) != gjk::GJK_COOK_EMPTY_MASK);
+    GJK_CHECK(shape.vertex_count() == 0 && shape.triangle_count() == 0);
+    GJK_CHECK(!shape.has_adjacency() && shape.soa()._vertex_count == 0);
+}
+
+int main()
+{
+    std::mt19937 rng(17);
+
+    test_cube(rng);
+    test_octahedron_and_tetrahedron(rng);
+    test_sphere_points();
+    test_errors();
+    test_recook();
+
+    return finish("test_cook");
+}
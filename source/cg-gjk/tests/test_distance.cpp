@@ -0,0 +1,174 @@
+///////////////////////////////////////////////////////////////////
+// GJK distance, separation and witness points against analytic answers
+///////////////////////////////////////////////////////////////////
+
+#include "test_common.hpp"
+
+using namespace s2cpp;
+using namespace s2cpp::gjk_test;
+
+// projection interval of the world space vertices on 'axis_'
+static void project(const gjk::mesh_object& object_, const std::vector<xfloat3>& vertices_, const xfloat3& axis_, float& min_, float& max_)
+{
+    min_ = std::numeric_limits<float>::infinity();
+    max_ = -std::numeric_limits<float>::infinity();
+    for(const auto& v : vertices_) {
+        const auto projection = dot_product(axis_, mxlib::transform(v, object_._model_mtx));
+        min_ = std::min(min_, projection);
+        max_ = std::max(max_, projection);
+    }
+}
+
+// witness points, separating axis and distance agree with each other and with the expected distance
+static void check_distance(
+    const gjk::distance_result& result_,
+    const float                 distance_,
+    const float                 tolerance_)
+{
+    GJK_CHECK_NEAR(result_._distance, distance_, tolerance_);
+    GJK_CHECK_NEAR(length(result_._separating_axis), 1.0f, 1e-4f);
+
+    // the witness points are '_distance' apart along the axis
+    const auto delta = result_._point_b - result_._point_a;
+    GJK_CHECK_NEAR(length(delta), result_._distance, tolerance_);
+    GJK_CHECK(length(delta - result_._separating_axis * result_._distance) <= tolerance_);
+}
+
+static void test_boxes(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> offset(-4.0f, 4.0f);
+
+    // two unit cubes (half extent 1), the closest features follow from the offset per axis
+    auto corners_a = box_corners(1.0f);
+    auto corners_b = box_corners(1.0f);
+
+    uint32_t tested = 0;
+    for(uint32_t k = 0; k < 500; ++k)
+    {
+        const auto t = xfloat3(offset(rng), offset(rng), offset(rng));
+        const auto gap = xfloat3(
+            std::max(0.0f, std::abs(t.x) - 2),
+            std::max(0.0f, std::abs(t.y) - 2),
+            std::max(0.0f, std::abs(t.z) - 2));
+        const auto expected = length(gap);
+
+        gjk::mesh_object alpha{ model_matrix(xfloat3(0, 0, 0)), corners_a.data(), 8 };
+        gjk::mesh_object beta { model_matrix(t), corners_b.data(), 8 };
+
+        gjk::distance_result result{};
+        const auto bits = gjk::distance(&alpha, &beta, &result);
+        if(expected < 0.02f)
+        {
+            // touching pairs can go either way
+            if(expected == 0) {
+                GJK_CHECK(bits & gjk::GJK_INTERSECTING_BIT);
+                GJK_CHECK(result._distance == 0);
+            }
+            continue;
+        }
+
+        GJK_CHECK(bits == gjk::GJK_EMPTY_MASK);
+        check_distance(result, expected, 1e-4f);
+
+        // witness points on the surfaces of the boxes
+        const auto local_a = result._point_a;
+        const auto local_b = result._point_b - t;
+        GJK_CHECK_NEAR(std::max({std::abs(local_a.x), std::abs(local_a.y), std::abs(local_a.z)}), 1.0f, 1e-4f);
+        GJK_CHECK_NEAR(std::max({std::abs(local_b.x), std::abs(local_b.y), std::abs(local_b.z)}), 1.0f, 1e-4f);
+
+        // the axis separates the boxes by exactly the distance
+        float min_a, max_a, min_b, max_b;
+        project(alpha, corners_a, result._separating_axis, min_a, max_a);
+        project(beta,  corners_b, result._separating_axis, min_b, max_b);
+        GJK_CHECK_NEAR(min_b - max_a, expected, 1e-4f);
+
+        ++tested;
+    }
+    GJK_CHECK(tested > 300);
+}
+
+static void test_rotated_hulls(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> angle(0.0f, 6.28f);
+
+    // sampled sphere hulls, separation of the centers minus the radii up to the sampling error
+    const auto points = sphere_points(400);
+    gjk::convex_shape shape{};
+    GJK_CHECK(gjk::cook_convex(points.data(), static_cast<uint32_t>(points.size()), &shape) == gjk::GJK_COOK_EMPTY_MASK);
+    std::vector<xfloat3> vertices(shape.vertices(), shape.vertices() + shape.vertex_count());
+
+    for(uint32_t k = 0; k < 200; ++k)
+    {
+        auto axis = xfloat3(unit(rng), unit(rng), unit(rng));
+        if(length(axis) < 0.1f) continue;
+        axis = axis * (1.0f / length(axis));
+
+        const auto gap = 0.1f + 2.0f * (unit(rng) * 0.5f + 0.5f);
+        const auto center_a = xfloat3(unit(rng), unit(rng), unit(rng));
+        gjk::mesh_object alpha{};
+        alpha._model_mtx    = model_matrix(center_a, angle(rng), 1.5f);
+        alpha._convex_shape = &shape;
+        gjk::mesh_object beta{};
+        beta._model_mtx     = model_matrix(center_a + axis * (2.5f + gap), angle(rng));
+        beta._convex_shape  = &shape;
+
+        gjk::distance_result result{};
+        GJK_CHECK(gjk::distance(&alpha, &beta, &result) == gjk::GJK_EMPTY_MASK);
+        check_distance(result, gap, 0.03f);
+        GJK_CHECK(dot_product(result._separating_axis, axis) > 0.98f);
+
+        // witness points are hull points, the axis separates the hulls
+        float min_a, max_a, min_b, max_b;
+        project(alpha, vertices, result._separating_axis, min_a, max_a);
+        project(beta,  vertices, result._separating_axis, min_b, max_b);
+        GJK_CHECK_NEAR(max_a, dot_product(result._separating_axis, result._point_a), 1e-4f);
+        GJK_CHECK_NEAR(min_b, dot_product(result._separating_axis, result._point_b), 1e-4f);
+        GJK_CHECK_NEAR(min_b - max_a, result._distance, 1e-4f);
+    }
+}
+
+static void test_primitives_and_margins()
+{
+    // spheres, the witness points are on the line between the centers
+    gjk::mesh_object alpha{};
+    alpha._model_mtx = model_matrix(xfloat3(1, 2, 3));
+    alpha._primitive = gjk::primitive_shape{ gjk::GJK_PRIMITIVE_SPHERE, 0.5f };
+    gjk::mesh_object beta{};
+    beta._model_mtx  = model_matrix(xfloat3(1, 2, 3) + xfloat3(3, 0, 4));
+    beta._primitive  = gjk::primitive_shape{ gjk::GJK_PRIMITIVE_SPHERE, 1.5f };
+
+    gjk::distance_result result{};
+    GJK_CHECK(gjk::distance(&alpha, &beta, &result) == gjk::GJK_EMPTY_MASK);
+    check_distance(result, 3.0f, 1e-4f);
+    GJK_CHECK(length(result._separating_axis - xfloat3(0.6f, 0, 0.8f)) <= 1e-4f);
+    GJK_CHECK(length(result._point_a - (xfloat3(1, 2, 3) + xfloat3(0.3f, 0, 0.4f))) <= 1e-4f);
+    GJK_CHECK(length(result._point_b - (xfloat3(1, 2, 3) + xfloat3(2.1f, 0, 2.8f))) <= 1e-4f);
+
+    // margins shrink the distance and move the witness points out of the cores
+    alpha._margin = 0.25f;
+    beta._margin  = 0.5f;
+    GJK_CHECK(gjk::distance(&alpha, &beta, &result) == gjk::GJK_EMPTY_MASK);
+    check_distance(result, 2.25f, 1e-4f);
+    GJK_CHECK(length(result._point_a - (xfloat3(1, 2, 3) + xfloat3(0.45f, 0, 0.6f))) <= 1e-4f);
+
+    // margins closing the gap, intersecting and no result
+    beta._margin = 3.0f;
+    GJK_CHECK(gjk::distance(&alpha, &beta, &result) & gjk::GJK_INTERSECTING_BIT);
+    GJK_CHECK(result._distance == 0);
+
+    // invalid input
+    GJK_CHECK(gjk::distance(&alpha, &alpha, &result) & gjk::GJK_INVALID_BIT);
+    GJK_CHECK(gjk::distance(nullptr, &beta, &result) & gjk::GJK_INVALID_BIT);
+}
+
+int main()
+{
+    std::mt19937 rng(23);
+
+    test_boxes(rng);
+    test_rotated_hulls(rng);
+    test_primitives_and_margins();
+
+    return finish("test_distance");
+}
@@ -0,0 +1,198 @@
+///////////////////////////////////////////////////////////////////
+// EPA and MPR contacts against analytic sphere and box answers
+///////////////////////////////////////////////////////////////////
+
+#include "test_common.hpp"
+
+using namespace s2cpp;
+using namespace s2cpp::gjk_test;
+
+// depth, normal (from alpha towards beta) and witness points of one contact
+static void check_contact(
+    const gjk::contact_result& contact_,
+    const float                depth_,
+    const xfloat3&             normal_,
+    const float                depth_tolerance_,
+    const float                normal_tolerance_)
+{
+    GJK_CHECK_NEAR(contact_._depth, depth_, depth_tolerance_);
+    GJK_CHECK(dot_product(contact_._normal, normal_) >= 1.0f - normal_tolerance_);
+    GJK_CHECK_NEAR(length(contact_._normal), 1.0f, 1e-4f);
+
+    // witness points are the deepest points of each object along the normal
+    const auto separation = dot_product(contact_._point_b - contact_._point_a, contact_._normal);
+    GJK_CHECK_NEAR(separation, -depth_, depth_tolerance_ * 2);
+}
+
+static void test_spheres(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> radius(0.3f, 2.0f);
+
+    gjk::epa_scratch scratch{};
+    for(uint32_t k = 0; k < 200; ++k)
+    {
+        const auto ra = radius(rng);
+        const auto rb = radius(rng);
+        auto axis = xfloat3(unit(rng), unit(rng), unit(rng));
+        if(length(axis) < 0.1f) continue;
+        axis = axis * (1.0f / length(axis));
+
+        // centers closer than the radii, never concentric
+        const auto overlap = (ra + rb) * (0.05f + 0.5f * (unit(rng) * 0.5f + 0.5f));
+        const auto center_distance = ra + rb - overlap;
+
+        gjk::mesh_object alpha{}, beta{};
+        alpha._model_mtx = model_matrix(xfloat3(unit(rng), unit(rng), unit(rng)));
+        alpha._primitive = gjk::primitive_shape{ gjk::GJK_PRIMITIVE_SPHERE, ra };
+        beta._model_mtx  = alpha._model_mtx;
+        beta._model_mtx[3]  += axis.x * center_distance;
+        beta._model_mtx[7]  += axis.y * center_distance;
+        beta._model_mtx[11] += axis.z * center_distance;
+        beta._primitive  = gjk::primitive_shape{ gjk::GJK_PRIMITIVE_SPHERE, rb };
+
+        gjk::contact_result epa{};
+        GJK_CHECK(gjk::penetration(&alpha, &beta, &epa, &scratch) & gjk::GJK_INTERSECTING_BIT);
+        check_contact(epa, overlap, axis, 2e-3f, 1e-3f);
+
+        gjk::contact_result mpr{};
+        GJK_CHECK(gjk::mpr_penetration(&alpha, &beta, &mpr) & gjk::GJK_INTERSECTING_BIT);
+        check_contact(mpr, overlap, axis, 5e-3f, 1e-2f);
+
+        // separated spheres, no contact
+        beta._model_mtx[3]  += axis.x * (overlap + 0.25f);
+        beta._model_mtx[7]  += axis.y * (overlap + 0.25f);
+        beta._model_mtx[11] += axis.z * (overlap + 0.25f);
+
+        gjk::contact_result none{};
+        GJK_CHECK(gjk::penetration(&alpha, &beta, &none, &scratch) == gjk::GJK_EMPTY_MASK);
+        GJK_CHECK(gjk::mpr_penetration(&alpha, &beta, &none) == gjk::GJK_EMPTY_MASK);
+    }
+}
+
+static void test_boxes(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> offset(-1.9f, 1.9f);
+
+    // two cubes of half extent 1, depth is the smallest overlap of the axes
+    auto corners_a = box_corners(1.0f);
+    auto corners_b = box_corners(1.0f);
+
+    gjk::epa_scratch scratch{};
+    uint32_t tested = 0;
+    for(uint32_t k = 0; k < 500; ++k)
+    {
+        const auto t = xfloat3(offset(rng), offset(rng), offset(rng));
+        const float overlaps[3] = { 2 - std::abs(t.x), 2 - std::abs(t.y), 2 - std::abs(t.z) };
+        const auto axis = static_cast<uint32_t>(std::min_element(overlaps, overlaps + 3) - overlaps);
+        const auto depth = overlaps[axis];
+
+        // a clear minimum axis, ties have several valid normals
+        float second = 4;
+        for(uint32_t i = 0; i < 3; ++i) {
+            if(i != axis) second = std::min(second, overlaps[i]);
+        }
+        if(second - depth < 0.05f || depth < 0.02f) continue;
+
+        const float components[3] = { t.x, t.y, t.z };
+        xfloat3 normal(0, 0, 0);
+        (axis == 0 ? normal.x : axis == 1 ? normal.y : normal.z) = components[axis] > 0 ? 1.0f : -1.0f;
+
+        gjk::mesh_object alpha{ model_matrix(xfloat3(0, 0, 0)), corners_a.data(), 8 };
+        gjk::mesh_object beta { model_matrix(t), corners_b.data(), 8 };
+
+        gjk::contact_result epa{};
+        GJK_CHECK(gjk::penetration(&alpha, &beta, &epa, &scratch) & gjk::GJK_INTERSECTING_BIT);
+        check_contact(epa, depth, normal, 1e-4f, 1e-4f);
+
+        gjk::contact_result mpr{};
+        GJK_CHECK(gjk::collide(&alpha, &beta, gjk::GJK_ALGORITHM_MPR, &mpr) & gjk::GJK_INTERSECTING_BIT);
+        check_contact(mpr, depth, normal, 1e-3f, 1e-3f);
+
+        ++tested;
+    }
+    GJK_CHECK(tested > 100);
+
+    // box primitive against the same box as a hull, face contact along +y
+    gjk::mesh_object hull{ model_matrix(xfloat3(0, 0, 0)), corners_a.data(), 8 };
+    gjk::mesh_object box{};
+    box._model_mtx = model_matrix(xfloat3(0.3f, 2.5f, -0.2f));
+    box._primitive = gjk::primitive_shape{ gjk::GJK_PRIMITIVE_BOX, 0, 0, xfloat3(2, 1.75f, 2) };
+
+    gjk::contact_result epa{};
+    GJK_CHECK(gjk::penetration(&hull, &box, &epa, &scratch) & gjk::GJK_INTERSECTING_BIT);
+    check_contact(epa, 0.25f, xfloat3(0, 1, 0), 1e-4f, 1e-4f);
+
+    // margins add up to the depth, the cores are 0.1 apart
+    gjk::mesh_object rounded_a{ model_matrix(xfloat3(0, 0, 0)), corners_a.data(), 8 };
+    gjk::mesh_object rounded_b{ model_matrix(xfloat3(2.1f, 0.2f, 0.1f)), corners_b.data(), 8 };
+    rounded_a._margin = 0.1f;
+    rounded_b._margin = 0.15f;
+
+    gjk::contact_result shallow{};
+    GJK_CHECK(gjk::penetration(&rounded_a, &rounded_b, &shallow, &scratch) & gjk::GJK_INTERSECTING_BIT);
+    check_contact(shallow, 0.15f, xfloat3(1, 0, 0), 1e-4f, 1e-4f);
+
+    // boolean queries see the margins too, thinner margins don't close the gap of the cores
+    GJK_CHECK(gjk::intersects(&rounded_a, &rounded_b) & gjk::GJK_INTERSECTING_BIT);
+
+    gjk::mesh_object thin_a{ rounded_a._model_mtx, corners_a.data(), 8 };
+    gjk::mesh_object thin_b{ rounded_b._model_mtx, corners_b.data(), 8 };
+    thin_a._margin = 0.04f;
+    thin_b._margin = 0.05f;
+    GJK_CHECK(gjk::intersects(&thin_a, &thin_b) == gjk::GJK_EMPTY_MASK);
+    GJK_CHECK(gjk::penetration(&thin_a, &thin_b, &shallow, &scratch) == gjk::GJK_EMPTY_MASK);
+}
+
+static void test_mpr_iterations(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> position(-1.5f, 1.5f);
+    std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+
+    const auto points = sphere_points(120);
+    gjk::convex_shape hull{};
+    GJK_CHECK(gjk::cook_convex(points.data(), static_cast<uint32_t>(points.size()), &hull) == gjk::GJK_COOK_EMPTY_MASK);
+    auto corners = box_corners(0.6f);
+
+    // no iterations to find a portal, the answer is unknown rather than separated
+    gjk::mesh_object overlapping_a{ model_matrix(xfloat3(0, 0, 0)), corners.data(), 8 };
+    gjk::mesh_object overlapping_b{};
+    overlapping_b._model_mtx    = model_matrix(xfloat3(0.5f, 0.2f, 0));
+    overlapping_b._convex_shape = &hull;
+    gjk::contact_result contact{};
+    GJK_CHECK(gjk::mpr_penetration(&overlapping_a, &overlapping_b, &contact, 0) == gjk::GJK_NOT_CONVERGED_BIT);
+
+    // converged answers match GJK, every contact has a unit normal
+    for(const uint32_t max_iter : {2u, 100u})
+    {
+        uint32_t converged = 0;
+        for(uint32_t k = 0; k < 500; ++k)
+        {
+            gjk::mesh_object alpha{ model_matrix(xfloat3(0, 0, 0), angle(rng)), corners.data(), 8 };
+            gjk::mesh_object beta{};
+            beta._model_mtx    = model_matrix(xfloat3(position(rng), position(rng), position(rng)), angle(rng));
+            beta._convex_shape = &hull;
+
+            const auto bits = gjk::mpr_penetration(&alpha, &beta, &contact, max_iter);
+            if(bits & gjk::GJK_INTERSECTING_BIT) {
+                GJK_CHECK_NEAR(length(contact._normal), 1.0f, 1e-4f);
+            }
+            if(!(bits & gjk::GJK_NOT_CONVERGED_BIT)) {
+                GJK_CHECK((bits & gjk::GJK_INTERSECTING_BIT) == (gjk::intersects(&alpha, &beta) & gjk::GJK_INTERSECTING_BIT));
+                ++converged;
+            }
+        }
+        GJK_CHECK(max_iter < 100 || converged > 450);
+    }
+}
+
+int main()
+{
+    std::mt19937 rng(13);
+
+    test_spheres(rng);
+    test_boxes(rng);
+    test_mpr_iterations(rng);
+
+    return finish("test_penetration");
+}
@@ -0,0 +1,123 @@
+///////////////////////////////////////////////////////////////////
+// GJK kernel policies and scalar types, the same answers for every configuration
+///////////////////////////////////////////////////////////////////
+
+#include "test_common.hpp"
+#include "cg_gjk_shapes.hpp"
+
+using namespace s2cpp;
+using namespace s2cpp::gjk_test;
+
+static void test_mesh_object_policies(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> position(-2.5f, 2.5f);
+    std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+
+    const auto points = sphere_points(150);
+    gjk::convex_shape hull{};
+    GJK_CHECK(gjk::cook_convex(points.data(), static_cast<uint32_t>(points.size()), &hull) == gjk::GJK_COOK_EMPTY_MASK);
+    auto corners = box_corners(0.8f);
+
+    fixed_list<xfloat3, 4> storage[16]{};
+    gjk::by_products_data by_products{};
+    by_products._simplex_construction_buffer._storage = storage;
+
+    uint32_t intersecting = 0;
+    for(uint32_t k = 0; k < 500; ++k)
+    {
+        gjk::mesh_object alpha{};
+        alpha._model_mtx    = model_matrix(xfloat3(position(rng), position(rng), position(rng)), angle(rng));
+        alpha._convex_shape = &hull;
+        gjk::mesh_object beta{ model_matrix(xfloat3(position(rng), position(rng), position(rng)), angle(rng)), corners.data(), 8 };
+
+        // every explicitly instantiated policy gives the same answer
+        const auto expected = gjk::intersects<gjk::default_policy>(&alpha, &beta);
+        GJK_CHECK(gjk::intersects(&alpha, &beta) == expected);
+        GJK_CHECK(gjk::intersects<gjk::trace_policy>(&alpha, &beta, 100, &by_products) == expected);
+        GJK_CHECK(gjk::intersects<gjk::boolean_policy>(&alpha, &beta) == expected);
+
+        // no duplicate support detection, stalls run to the cap but the answer is the same
+        const auto capped = gjk::intersects<gjk::boolean_capped_policy>(&alpha, &beta);
+        GJK_CHECK((capped & gjk::GJK_INTERSECTING_BIT) == (expected & gjk::GJK_INTERSECTING_BIT));
+
+        intersecting += (expected & gjk::GJK_INTERSECTING_BIT) != 0;
+    }
+    GJK_CHECK(intersecting > 25 && intersecting < 475);
+}
+
+static void test_shape_policies(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> position(-2.0f, 2.0f);
+    std::uniform_real_distribution<float> radius(0.2f, 1.0f);
+
+    using witness_policy = gjk::gjk_policy<true, false>;
+    using double_policy  = gjk::gjk_policy<false, false, double>;
+
+    for(uint32_t k = 0; k < 500; ++k)
+    {
+        const gjk::capsule_shape capsule{
+            xfloat3(position(rng), position(rng), position(rng)), xfloat3(position(rng), position(rng), position(rng)), radius(rng) };
+        const gjk::sphere_shape sphere{ xfloat3(position(rng), position(rng), position(rng)), radius(rng) };
+
+        const auto expected = gjk::intersects<gjk::boolean_policy>(capsule, sphere);
+        GJK_CHECK(gjk::intersects<witness_policy>(capsule, sphere) == expected);
+        GJK_CHECK((gjk::intersects<double_policy>(capsule, sphere) & gjk::GJK_INTERSECTING_BIT) == (expected & gjk::GJK_INTERSECTING_BIT));
+    }
+}
+
+static void test_large_world(std::mt19937& rng)
+{
+    std::uniform_real_distribution<double> unit(-1.0, 1.0);
+    std::uniform_real_distribution<double> gap(0.001, 0.01);
+
+    // double precision spheres far from the origin, one millimetre scale gaps
+    const auto origin = gjk::xdouble3(1e8, -2e8, 5e7);
+    for(uint32_t k = 0; k < 200; ++k)
+    {
+        auto axis = gjk::xdouble3(unit(rng), unit(rng), unit(rng));
+        if(dot_product(axis, axis) < 0.01) continue;
+        axis = axis * (1.0 / std::sqrt(dot_product(axis, axis)));
+
+        const auto separation = (k % 2 ? 1.0 : -1.0) * gap(rng);
+        const gjk::sphere_shape_d alpha{ origin, 1.0 };
+        const gjk::sphere_shape_d beta { origin + axis * (1.5 + separation), 0.5 };
+        const auto intersecting = separation < 0;
+
+        // double kernel, and the float kernel on the differences taken in double
+        GJK_CHECK(((gjk::intersects(alpha, beta) & gjk::GJK_INTERSECTING_BIT) != 0) == intersecting);
+        GJK_CHECK(((gjk::intersects<gjk::boolean_policy>(alpha, beta) & gjk::GJK_INTERSECTING_BIT) != 0) == intersecting);
+    }
+
+    // mesh objects far from the origin, the gap follows from the stored single precision translations
+    auto corners_a = box_corners(1.0f);
+    auto corners_b = box_corners(1.0f);
+    const float offset = 98304.0f;
+    uint32_t tested = 0;
+    for(uint32_t k = 0; k < 300; ++k)
+    {
+        const auto t = xfloat3(static_cast<float>(unit(rng)) * 2.5f, static_cast<float>(unit(rng)) * 2.5f, static_cast<float>(unit(rng)) * 2.5f);
+        gjk::mesh_object alpha{ model_matrix(xfloat3(offset, -offset, offset)), corners_a.data(), 8 };
+        gjk::mesh_object beta { model_matrix(xfloat3(offset + t.x, -offset + t.y, offset + t.z)), corners_b.data(), 8 };
+
+        double overlap = std::numeric_limits<double>::infinity();
+        for(const uint32_t i : {3u, 7u, 11u}) {
+            overlap = std::min(overlap, 2.0 - std::abs(static_cast<double>(beta._model_mtx[i]) - static_cast<double>(alpha._model_mtx[i])));
+        }
+        if(std::abs(overlap) < 0.05) continue;
+
+        GJK_CHECK(((gjk::intersects<gjk::rebased_policy>(&alpha, &beta) & gjk::GJK_INTERSECTING_BIT) != 0) == (overlap > 0));
+        ++tested;
+    }
+    GJK_CHECK(tested > 200);
+}
+
+int main()
+{
+    std::mt19937 rng(31);
+
+    test_mesh_object_policies(rng);
+    test_shape_policies(rng);
+    test_large_world(rng);
+
+    return finish("test_policy");
+}
@@ -0,0 +1,222 @@
+///////////////////////////////////////////////////////////////////
+// templated GJK over shape types against analytic overlap tests
+///////////////////////////////////////////////////////////////////
+
+#include "test_common.hpp"
+#include "cg_gjk_shapes.hpp"
+
+using namespace s2cpp;
+using namespace s2cpp::gjk_test;
+
+// pairs closer to touching than this can go either way
+static constexpr float TOUCH_TOLERANCE = 1e-3f;
+
+static float segment_distance(const xfloat3& a_, const xfloat3& b_, const xfloat3& p_)
+{
+    const auto ab = b_ - a_;
+    const auto t  = std::clamp(dot_product(p_ - a_, ab) / dot_product(ab, ab), 0.0f, 1.0f);
+    return length(p_ - (a_ + ab * t));
+}
+
+// distance of a point to the box, zero inside. the model matrix of the tests is a rotation plus translation
+static float box_distance(const gjk::box_shape& box_, const xfloat3& p_)
+{
+    const auto& m = box_._model_mtx;
+    const auto d  = p_ - xfloat3(m[3], m[7], m[11]);
+    const auto local = xfloat3(
+        m[0] * d.x + m[4] * d.y + m[8]  * d.z,
+        m[1] * d.x + m[5] * d.y + m[9]  * d.z,
+        m[2] * d.x + m[6] * d.y + m[10] * d.z);
+    const auto outside = xfloat3(
+        std::max(0.0f, std::abs(local.x) - box_._half_extents.x),
+        std::max(0.0f, std::abs(local.y) - box_._half_extents.y),
+        std::max(0.0f, std::abs(local.z) - box_._half_extents.z));
+    return length(outside);
+}
+
+// intersecting bit against the signed gap of the analytic answer, touching pairs are skipped
+static bool check_gap(const gjk::result_bits bits_, const float gap_)
+{
+    if(std::abs(gap_) < TOUCH_TOLERANCE) {
+        return false;
+    }
+    GJK_CHECK(((bits_ & gjk::GJK_INTERSECTING_BIT) != 0) == (gap_ < 0));
+    GJK_CHECK(!(bits_ & gjk::GJK_INVALID_BIT));
+    return true;
+}
+
+static void test_analytic_pairs(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> position(-2.0f, 2.0f);
+    std::uniform_real_distribution<float> radius(0.2f, 1.0f);
+    std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+
+    uint32_t tested = 0;
+    uint32_t intersecting = 0;
+    for(uint32_t k = 0; k < 1000; ++k)
+    {
+        const auto random_point = [&]() { return xfloat3(position(rng), position(rng), position(rng)); };
+
+        const gjk::sphere_shape  sphere{ random_point(), radius(rng) };
+        const gjk::sphere_shape  other { random_point(), radius(rng) };
+        const gjk::capsule_shape capsule{ random_point(), random_point(), radius(rng) };
+        const gjk::box_shape     box{ model_matrix(random_point(), angle(rng)), xfloat3(radius(rng), radius(rng), radius(rng)) };
+
+        const auto sphere_sphere = length(other._center - sphere._center) - sphere._radius - other._radius;
+        tested += check_gap(gjk::intersects(sphere, other), sphere_sphere);
+
+        const auto capsule_sphere = segment_distance(capsule._a, capsule._b, sphere._center) - capsule._radius - sphere._radius;
+        tested += check_gap(gjk::intersects(capsule, sphere), capsule_sphere);
+        tested += check_gap(gjk::intersects(sphere, capsule), capsule_sphere);
+
+        // a sphere center inside the box has no useful analytic gap
+        const auto inside = box_distance(box, sphere._center);
+        if(inside > 0) {
+            tested += check_gap(gjk::intersects(box, sphere), inside - sphere._radius);
+        }
+
+        intersecting += sphere_sphere < 0;
+    }
+    GJK_CHECK(tested > 2500);
+    GJK_CHECK(intersecting > 50 && intersecting < 950);
+}
+
+static void test_mesh_object_pairs(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> position(-2.5f, 2.5f);
+    std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+
+    // the templated path and the mesh object path agree on the same boxes
+    auto corners_a = box_corners(1.0f);
+    auto corners_b = box_corners(1.0f);
+    for(uint32_t k = 0; k < 500; ++k)
+    {
+        const auto matrix_a = model_matrix(xfloat3(position(rng), position(rng), position(rng)), angle(rng));
+        const auto matrix_b = model_matrix(xfloat3(position(rng), position(rng), position(rng)), angle(rng));
+
+        const gjk::mesh_object object_a{ matrix_a, corners_a.data(), 8 };
+        const gjk::mesh_object object_b{ matrix_b, corners_b.data(), 8 };
+        const gjk::box_shape   box_b{ matrix_b, xfloat3(1, 1, 1) };
+
+        const auto expected = gjk::intersects(&object_a, &object_b) & gjk::GJK_INTERSECTING_BIT;
+        GJK_CHECK((gjk::intersects(object_a, object_b) & gjk::GJK_INTERSECTING_BIT) == expected);
+        GJK_CHECK((gjk::intersects(object_a, box_b)    & gjk::GJK_INTERSECTING_BIT) == expected);
+    }
+}
+
+static void test_dispatch()
+{
+    using dispatch = gjk::default_shape_dispatch;
+    static_assert(dispatch::KIND_COUNT == 4);
+    static_assert(dispatch::kind_of<gjk::sphere_shape>() == 0 && dispatch::kind_of<gjk::mesh_object>() == 3);
+
+    auto corners = box_corners(0.5f);
+    const gjk::sphere_shape  sphere{ xfloat3(0, 0, 0), 0.5f };
+    const gjk::capsule_shape capsule{ xfloat3(0.8f, -1, 0), xfloat3(0.8f, 1, 0), 0.4f };
+    const gjk::box_shape     box{ model_matrix(xfloat3(0, 0.9f, 0), 0.3f), xfloat3(0.5f, 0.5f, 0.5f) };
+    const gjk::mesh_object   mesh{ model_matrix(xfloat3(0, 0, 5)), corners.data(), 8 };
+
+    const gjk::shape_ref refs[4] = {
+        dispatch::make_ref(sphere), dispatch::make_ref(capsule), dispatch::make_ref(box), dispatch::make_ref(mesh) };
+
+    // every ordered pair of the table is the direct instantiation
+    const auto direct = [&](const uint32_t a, const uint32_t b) {
+        const auto with = [&](const auto& alpha) {
+            switch(b) {
+                case 0:  return gjk::intersects(alpha, sphere);
+                case 1:  return gjk::intersects(alpha, capsule);
+                case 2:  return gjk::intersects(alpha, box);
+                default: return gjk::intersects(alpha, mesh);
+            }
+        };
+        switch(a) {
+            case 0:  return with(sphere);
+            case 1:  return with(capsule);
+            case 2:  return with(box);
+            default: return with(mesh);
+        }
+    };
+
+    uint32_t intersecting = 0;
+    for(uint32_t a = 0; a < 4; ++a) {
+        for(uint32_t b = 0; b < 4; ++b) {
+            if(a == b) continue;
+            const auto bits = dispatch::intersects(refs[a], refs[b]);
+            GJK_CHECK(bits == direct(a, b));
+            intersecting += (bits & gjk::GJK_INTERSECTING_BIT) != 0;
+        }
+    }
+    // sphere, capsule and box overlap each other, the mesh is far away
+    GJK_CHECK(intersecting == 6);
+
+    // unknown kinds and null shapes are invalid
+    GJK_CHECK(dispatch::intersects(gjk::shape_ref{ 4, &sphere }, refs[1]) & gjk::GJK_INVALID_BIT);
+    GJK_CHECK(dispatch::intersects(refs[0], gjk::shape_ref{ 1, nullptr }) & gjk::GJK_INVALID_BIT);
+}
+
+static void test_adapters(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> position(-2.0f, 2.0f);
+    std::uniform_real_distribution<float> radius(0.2f, 1.0f);
+    std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+
+    uint32_t tested = 0;
+    for(uint32_t k = 0; k < 1000; ++k)
+    {
+        const auto random_point = [&]() { return xfloat3(position(rng), position(rng), position(rng)); };
+
+        const gjk::sphere_shape probe{ random_point(), radius(rng) };
+        const gjk::sphere_shape sphere{ random_point(), radius(rng) };
+        const auto motion = random_point();
+
+        // a swept sphere is the capsule over its motion
+        const gjk::swept_shape<gjk::sphere_shape> swept{ sphere, motion };
+        const auto capsule_gap = segment_distance(sphere._center, sphere._center + motion, probe._center) - sphere._radius - probe._radius;
+        tested += check_gap(gjk::intersects(swept, probe), capsule_gap);
+        tested += check_gap(gjk::intersects(probe, swept), capsule_gap);
+
+        // so is the convex hull of the start and end spheres
+        const gjk::convex_hull_shape<gjk::sphere_shape, gjk::sphere_shape> hull{ sphere, gjk::sphere_shape{ sphere._center + motion, sphere._radius } };
+        tested += check_gap(gjk::intersects(hull, probe), capsule_gap);
+
+        // a box plus a sphere is the rounded box
+        const gjk::box_shape box{ model_matrix(random_point(), angle(rng)), xfloat3(radius(rng), radius(rng), radius(rng)) };
+        const auto rounding = radius(rng) * 0.5f;
+        const gjk::minkowski_sum_shape<gjk::box_shape, gjk::sphere_shape> rounded{ box, gjk::sphere_shape{ xfloat3(0, 0, 0), rounding } };
+        const auto inside = box_distance(box, probe._center);
+        if(inside > 0) {
+            tested += check_gap(gjk::intersects(rounded, probe), inside - rounding - probe._radius);
+        }
+
+        // a uniformly scaled and moved unit sphere
+        const auto scale = radius(rng) * 2.0f;
+        const gjk::transformed_shape<gjk::sphere_shape> transformed{ 
+            model_matrix(sphere._center, angle(rng), scale), gjk::sphere_shape{ xfloat3(0, 0, 0), 1.0f } };
+        const auto scaled_gap = length(probe._center - sphere._center) - scale - probe._radius;
+        tested += check_gap(gjk::intersects(transformed, probe), scaled_gap);
+    }
+    GJK_CHECK(tested > 3500);
+
+    // adapter support points and centers directly
+    const gjk::sphere_shape unit{ xfloat3(1, 0, 0), 1.0f };
+    const gjk::swept_shape<gjk::sphere_shape> swept{ unit, xfloat3(0, 4, 0) };
+    GJK_CHECK(length(support(swept, xfloat3(0, 1, 0))  - xfloat3(1, 5, 0))  <= 1e-6f);
+    GJK_CHECK(length(support(swept, xfloat3(0, -1, 0)) - xfloat3(1, -1, 0)) <= 1e-6f);
+    GJK_CHECK(length(center(swept) - xfloat3(1, 2, 0)) <= 1e-6f);
+
+    const gjk::minkowski_sum_shape<gjk::sphere_shape, gjk::sphere_shape> sum{ unit, gjk::sphere_shape{ xfloat3(0, 0, 3), 0.5f } };
+    GJK_CHECK(length(support(sum, xfloat3(1, 0, 0)) - xfloat3(2.5f, 0, 3)) <= 1e-6f);
+    GJK_CHECK(length(center(sum) - xfloat3(1, 0, 3)) <= 1e-6f);
+}
+
+int main()
+{
+    std::mt19937 rng(29);
+
+    test_analytic_pairs(rng);
+    test_mesh_object_pairs(rng);
+    test_dispatch();
+    test_adapters(rng);
+
+    return finish("test_shapes");
+}
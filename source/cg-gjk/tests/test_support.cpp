@@ -0,0 +1,145 @@
+///////////////////////////////////////////////////////////////////
+// support search kernels and the signed volumes subalgorithm
+///////////////////////////////////////////////////////////////////
+
+#include "test_common.hpp"
+#include "cg_gjk_shapes.hpp"
+
+using namespace s2cpp;
+using namespace s2cpp::gjk_test;
+
+// largest projection of the world space vertices, ties make the index ambiguous, the value isn't
+static float brute_force_support(const gjk::mesh_object& object_, const xfloat3* vertices_, const uint32_t count_, const xfloat3& direction_)
+{
+    auto best = -std::numeric_limits<float>::infinity();
+    for(uint32_t i = 0; i < count_; ++i) {
+        best = std::max(best, dot_product(direction_, mxlib::transform(vertices_[i], object_._model_mtx)));
+    }
+    return best;
+}
+
+static void test_soa_arg_max(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    // counts around the padding of the SIMD lanes
+    for(const uint32_t count : {3u, 7u, 8u, 9u, 16u, 17u, 63u, 200u})
+    {
+        std::vector<xfloat3> vertices(count);
+        for(auto& v : vertices) {
+            v = xfloat3(unit(rng), unit(rng), unit(rng));
+        }
+        // repeated maximum, the padding repeats the first vertex too
+        vertices[count - 1] = vertices[0];
+
+        gjk::soa_vertices soa{};
+        gjk::build_soa_vertices(vertices.data(), count, &soa);
+        GJK_CHECK(soa._vertex_count == count);
+        GJK_CHECK(soa._x.size() % gjk::GJK_SOA_PADDING == 0 && soa._x.size() >= count);
+
+        gjk::mesh_object object_{ model_matrix(xfloat3(unit(rng), unit(rng), unit(rng)), unit(rng) * 3.0f), vertices.data(), count };
+        object_._soa_vertices = &soa;
+
+        for(uint32_t k = 0; k < 200; ++k) {
+            const auto direction = xfloat3(unit(rng), unit(rng), unit(rng));
+            const auto expected = brute_force_support(object_, vertices.data(), count, direction);
+            GJK_CHECK_NEAR(dot_product(direction, gjk::support(object_, direction)), expected, 1e-5f);
+        }
+        // the first vertex itself
+        const auto first = mxlib::transform(vertices[0], object_._model_mtx) - mxlib::transform(xfloat3(0, 0, 0), object_._model_mtx);
+        GJK_CHECK_NEAR(dot_product(first, gjk::support(object_, first)), brute_force_support(object_, vertices.data(), count, first), 1e-5f);
+    }
+}
+
+static void test_hull_search(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    // large enough for hill climbing, with and without the direction table
+    const auto points = sphere_points(500);
+    for(const bool lut : {false, true})
+    {
+        gjk::cook_options options{};
+        options._build_direction_lut = lut;
+        gjk::convex_shape shape{};
+        GJK_CHECK(gjk::cook_convex(points.data(), static_cast<uint32_t>(points.size()), &shape, options) == gjk::GJK_COOK_EMPTY_MASK);
+        GJK_CHECK(shape.vertex_count() >= gjk::GJK_HILL_CLIMB_MIN_VERTICES);
+
+        gjk::mesh_object object_{};
+        object_._model_mtx = model_matrix(xfloat3(1, 2, 3), 0.7f, 1.5f);
+        object_._convex_shape = &shape;
+
+        for(uint32_t k = 0; k < 500; ++k) {
+            const auto direction = xfloat3(unit(rng), unit(rng), unit(rng));
+            const auto expected = brute_force_support(object_, shape.vertices(), shape.vertex_count(), direction);
+            GJK_CHECK_NEAR(dot_product(direction, gjk::support(object_, direction)), expected, 1e-5f);
+        }
+    }
+}
+
+template<typename Vec>
+static void test_signed_volumes()
+{
+    using scalar = gjk::vec_scalar_t<Vec>;
+    const auto near = [](const Vec& a, const Vec& b) {
+        const auto d = a - b;
+        return dot_product(d, d) <= scalar(1e-10);
+    };
+
+    // segment, closest to an end point and to the inside
+    {
+        const Vec points[2] = { Vec(1, 1, 0), Vec(3, 1, 0) };
+        const auto closest = gjk::detail::signed_volumes(points, 2);
+        GJK_CHECK(closest._count == 1 && closest._indices[0] == 0);
+        GJK_CHECK(near(closest._point, Vec(1, 1, 0)));
+    }
+    {
+        const Vec points[2] = { Vec(-1, 1, 0), Vec(3, 1, 0) };
+        const auto closest = gjk::detail::signed_volumes(points, 2);
+        GJK_CHECK(closest._count == 2);
+        GJK_CHECK(near(closest._point, Vec(0, 1, 0)));
+        GJK_CHECK_NEAR(closest._weights[0] + closest._weights[1], scalar(1), scalar(1e-6));
+    }
+
+    // triangle, face and edge regions
+    {
+        const Vec points[3] = { Vec(-1, -1, 2), Vec(3, -1, 2), Vec(-1, 3, 2) };
+        const auto closest = gjk::detail::signed_volumes(points, 3);
+        GJK_CHECK(closest._count == 3);
+        GJK_CHECK(near(closest._point, Vec(0, 0, 2)));
+    }
+    {
+        const Vec points[3] = { Vec(1, -1, 0), Vec(1, 1, 0), Vec(3, 0, 0) };
+        const auto closest = gjk::detail::signed_volumes(points, 3);
+        GJK_CHECK(closest._count == 2);
+        GJK_CHECK(near(closest._point, Vec(1, 0, 0)));
+    }
+
+    // tetrahedron enclosing the origin and one with the origin in front of a face
+    {
+        const Vec points[4] = { Vec(1, 1, 1), Vec(1, -1, -1), Vec(-1, 1, -1), Vec(-1, -1, 1) };
+        const auto closest = gjk::detail::signed_volumes(points, 4);
+        GJK_CHECK(closest._count == 4);
+    }
+    {
+        const Vec points[4] = { Vec(-1, -1, 1), Vec(3, -1, 1), Vec(-1, 3, 1), Vec(0, 0, 5) };
+        const auto closest = gjk::detail::signed_volumes(points, 4);
+        GJK_CHECK(closest._count == 3);
+        GJK_CHECK(near(closest._point, Vec(0, 0, 1)));
+        for(uint32_t i = 0; i < closest._count; ++i) {
+            GJK_CHECK(closest._indices[i] != 3);
+        }
+    }
+}
+
+int main()
+{
+    std::mt19937 rng(19);
+
+    test_soa_arg_max(rng);
+    test_hull_search(rng);
+    test_signed_volumes<xfloat3>();
+    test_signed_volumes<gjk::xdouble3>();
+
+    return finish("test_support");
+}
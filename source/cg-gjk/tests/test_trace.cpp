@@ -0,0 +1,117 @@
+///////////////////////////////////////////////////////////////////
+// simplex trace ring over caller provided storage
+///////////////////////////////////////////////////////////////////
+
+#include "test_common.hpp"
+#include "cg_gjk_shapes.hpp"
+
+using namespace s2cpp;
+using namespace s2cpp::gjk_test;
+
+static fixed_list<xfloat3, 4> snapshot(const float value_)
+{
+    fixed_list<xfloat3, 4> simplex{};
+    simplex.add(xfloat3(value_, 0, 0));
+    return simplex;
+}
+
+static bool same_snapshot(const fixed_list<xfloat3, 4>& a_, const fixed_list<xfloat3, 4>& b_)
+{
+    if(a_.size() != b_.size()) {
+        return false;
+    }
+    for(uint32_t i = 0; i < a_.size(); ++i) {
+        if(length(a_[i] - b_[i]) != 0) return false;
+    }
+    return true;
+}
+
+static void test_ring()
+{
+    fixed_list<xfloat3, 4> storage[3]{};
+    gjk::simplex_trace trace{};
+    trace._storage = storage;
+    GJK_CHECK(trace.capacity() == 3 && trace.size() == 0);
+
+    trace.push(snapshot(0));
+    trace.push(snapshot(1));
+    GJK_CHECK(trace._written == 2 && trace.size() == 2);
+    GJK_CHECK(trace[0][0].x == 0 && trace[1][0].x == 1);
+
+    // wrapped twice, the latest three are kept oldest first
+    for(uint32_t i = 2; i < 8; ++i) {
+        trace.push(snapshot(static_cast<float>(i)));
+    }
+    GJK_CHECK(trace._written == 8 && trace.size() == 3);
+    GJK_CHECK(trace[0][0].x == 5 && trace[1][0].x == 6 && trace[2][0].x == 7);
+
+    trace.reset();
+    GJK_CHECK(trace._written == 0 && trace.size() == 0);
+    trace.push(snapshot(9));
+    GJK_CHECK(trace.size() == 1 && trace[0][0].x == 9);
+
+    // no storage, tracing is disabled
+    gjk::simplex_trace disabled{};
+    disabled.push(snapshot(1));
+    GJK_CHECK(disabled._written == 0 && disabled.size() == 0);
+}
+
+// the ring of a query keeps the tail of the full trace
+template<typename Query>
+static void check_tail(const Query& query_)
+{
+    fixed_list<xfloat3, 4> full_storage[64]{};
+    gjk::by_products_data full{};
+    full._simplex_construction_buffer._storage = full_storage;
+    const auto full_bits = query_(full);
+    const auto& full_trace = full._simplex_construction_buffer;
+    GJK_CHECK(full_trace._written > 2 && full_trace._written == full_trace.size());
+
+    fixed_list<xfloat3, 4> ring_storage[2]{};
+    gjk::by_products_data ring{};
+    ring._simplex_construction_buffer._storage = ring_storage;
+    GJK_CHECK(query_(ring) == full_bits);
+    const auto& ring_trace = ring._simplex_construction_buffer;
+    GJK_CHECK(ring_trace._written == full_trace._written && ring_trace.size() == 2);
+
+    for(uint32_t i = 0; i < 2; ++i) {
+        GJK_CHECK(same_snapshot(ring_trace[i], full_trace[full_trace.size() - 2 + i]));
+    }
+    GJK_CHECK(ring._simplex_points.size() == full._simplex_points.size());
+
+    // the storage is kept between queries, the ring restarts
+    GJK_CHECK(query_(ring) == full_bits);
+    GJK_CHECK(ring_trace._written == full_trace._written);
+}
+
+static void test_queries()
+{
+    const auto points = sphere_points(300);
+    gjk::convex_shape hull{};
+    GJK_CHECK(gjk::cook_convex(points.data(), static_cast<uint32_t>(points.size()), &hull) == gjk::GJK_COOK_EMPTY_MASK);
+
+    gjk::mesh_object alpha{};
+    alpha._model_mtx    = model_matrix(xfloat3(0, 0, 0), 0.4f);
+    alpha._convex_shape = &hull;
+    gjk::mesh_object beta{};
+    beta._model_mtx     = model_matrix(xfloat3(1.3f, 0.7f, 0.2f), -0.9f);
+    beta._convex_shape  = &hull;
+
+    check_tail([&](gjk::by_products_data& by_products) {
+        return gjk::intersects(&alpha, &beta, 100, &by_products);
+    });
+
+    const gjk::capsule_shape capsule{ xfloat3(-1, -1, 0), xfloat3(1, 1, 0.5f), 0.3f };
+    const gjk::box_shape     box{ model_matrix(xfloat3(0.2f, 0.1f, 0.6f), 0.7f), xfloat3(0.5f, 0.25f, 0.4f) };
+    check_tail([&](gjk::by_products_data& by_products) {
+        return gjk::intersects<gjk::trace_policy>(capsule, box, 100, &by_products);
+    });
+}
+
+int main()
+{
+    test_ring();
+    test_queries();
+
+    return finish("test_trace");
+}
@@ -0,0 +1,108 @@
+///////////////////////////////////////////////////////////////////
+// warm started GJK against cold queries over moving pairs
+///////////////////////////////////////////////////////////////////
+
+#include "test_common.hpp"
+
+using namespace s2cpp;
+using namespace s2cpp::gjk_test;
+
+static void test_moving_pairs()
+{
+    const auto points = sphere_points(200);
+    gjk::convex_shape hull{};
+    GJK_CHECK(gjk::cook_convex(points.data(), static_cast<uint32_t>(points.size()), &hull) == gjk::GJK_COOK_EMPTY_MASK);
+    auto corners = box_corners(0.75f);
+
+    gjk::pair_cache cache{};
+    const auto pair_id = gjk::pair_cache::make_pair_id(1, 2);
+
+    // the box passes through the hull and back, small steps between the frames
+    uint32_t intersecting = 0;
+    uint32_t separated    = 0;
+    for(uint32_t frame = 0; frame < 400; ++frame)
+    {
+        const auto t = static_cast<float>(frame) * 0.0314f;
+        gjk::mesh_object alpha{};
+        alpha._model_mtx    = model_matrix(xfloat3(0, 0, 0), t * 0.5f);
+        alpha._convex_shape = &hull;
+        gjk::mesh_object beta{ model_matrix(xfloat3(3.5f * std::cos(t), 0.4f * std::sin(3 * t), 0.2f), t), corners.data(), 8 };
+
+        const auto cold = gjk::intersects(&alpha, &beta);
+        auto& entry = cache.entry(pair_id);
+        const auto warm = gjk::intersects(&alpha, &beta, 100, nullptr, &entry);
+        GJK_CHECK((cold & gjk::GJK_INTERSECTING_BIT) == (warm & gjk::GJK_INTERSECTING_BIT));
+
+        // intersecting pairs keep the enclosing tetrahedron, pairs rejected by the 
+        // bounds leave the entry as it was
+        if(warm & gjk::GJK_INTERSECTING_BIT) {
+            GJK_CHECK(entry._count == 4);
+            ++intersecting;
+        } else {
+            ++separated;
+        }
+
+        // same transforms again, an intersecting pair is answered from the cache without iterating
+        fixed_list<xfloat3, 4> storage[8]{};
+        gjk::by_products_data by_products{};
+        by_products._simplex_construction_buffer._storage = storage;
+        const auto repeated = gjk::intersects(&alpha, &beta, 100, &by_products, &entry);
+        GJK_CHECK((repeated & gjk::GJK_INTERSECTING_BIT) == (cold & gjk::GJK_INTERSECTING_BIT));
+        if(cold & gjk::GJK_INTERSECTING_BIT) {
+            GJK_CHECK(by_products._simplex_construction_buffer._written == 0);
+            GJK_CHECK(by_products._simplex_points.size() == 4);
+        }
+    }
+    GJK_CHECK(intersecting > 50 && separated > 50);
+    GJK_CHECK(cache.size() == 1);
+
+    // ordered pairs have their own entries
+    GJK_CHECK(gjk::pair_cache::make_pair_id(1, 2) != gjk::pair_cache::make_pair_id(2, 1));
+    cache.remove(pair_id);
+    GJK_CHECK(cache.size() == 0);
+}
+
+static void test_stale_entry()
+{
+    const auto points = sphere_points(200);
+    gjk::convex_shape hull{};
+    GJK_CHECK(gjk::cook_convex(points.data(), static_cast<uint32_t>(points.size()), &hull) == gjk::GJK_COOK_EMPTY_MASK);
+
+    // entry of two large hulls
+    gjk::mesh_object alpha{};
+    alpha._model_mtx    = model_matrix(xfloat3(0, 0, 0));
+    alpha._convex_shape = &hull;
+    gjk::mesh_object beta{};
+    beta._model_mtx     = model_matrix(xfloat3(1, 0.5f, 0));
+    beta._convex_shape  = &hull;
+
+    gjk::simplex_cache_entry entry{};
+    GJK_CHECK(gjk::intersects(&alpha, &beta, 100, nullptr, &entry) & gjk::GJK_INTERSECTING_BIT);
+    GJK_CHECK(entry._count == 4);
+
+    // the objects now use 8 vertex boxes, the cached indices are out of range
+    auto corners_a = box_corners(1.0f);
+    auto corners_b = box_corners(1.0f);
+    gjk::mesh_object box_a{ model_matrix(xfloat3(0, 0, 0)), corners_a.data(), 8 };
+    gjk::mesh_object box_b{ model_matrix(xfloat3(2.5f, 0, 0)), corners_b.data(), 8 };
+    GJK_CHECK(gjk::intersects(&box_a, &box_b, 100, nullptr, &entry) == gjk::GJK_EMPTY_MASK);
+
+    box_b._model_mtx = model_matrix(xfloat3(1.5f, 0, 0));
+    GJK_CHECK(gjk::intersects(&box_a, &box_b, 100, nullptr, &entry) & gjk::GJK_INTERSECTING_BIT);
+
+    // primitives reuse only the direction
+    gjk::mesh_object sphere{};
+    sphere._model_mtx = model_matrix(xfloat3(0, 3, 0));
+    sphere._primitive = gjk::primitive_shape{ gjk::GJK_PRIMITIVE_SPHERE, 0.5f };
+    GJK_CHECK(gjk::intersects(&box_a, &sphere, 100, nullptr, &entry) == gjk::GJK_EMPTY_MASK);
+    sphere._model_mtx = model_matrix(xfloat3(0, 1.25f, 0));
+    GJK_CHECK(gjk::intersects(&box_a, &sphere, 100, nullptr, &entry) & gjk::GJK_INTERSECTING_BIT);
+}
+
+int main()
+{
+    test_moving_pairs();
+    test_stale_entry();
+
+    return finish("test_warm_start");
+}